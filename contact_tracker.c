@@ -0,0 +1,181 @@
+// contact_tracker.c
+#include "contact_tracker.h"
+
+// One active contact between two drones.
+typedef struct {
+    int in_use;
+    int drone_id1, drone_id2;   // drone_id1 < drone_id2
+    int start_step, last_step;
+    int start_x, start_y, start_z;
+    int last_x, last_y, last_z;
+    int cell_changes;
+} ContactEpisode;
+
+static ContactEpisode contact_table[CONTACT_TABLE_SIZE];
+static int contact_table_used = 0;
+
+// Ring buffer of records not yet consumed by the report thread.
+static ContactRecord pending_records[CONTACT_PENDING_CAPACITY];
+static int pending_head = 0;
+static int pending_count = 0;
+static int dropped_records = 0;
+
+static unsigned contact_hash(int id1, int id2) {
+    unsigned h = (unsigned)id1 * 2654435761u ^ (unsigned)id2 * 40503u;
+    h ^= h >> 15;
+    return h & (CONTACT_TABLE_SIZE - 1);
+}
+
+static void push_record(const ContactRecord* record) {
+    if (pending_count == CONTACT_PENDING_CAPACITY) {
+        dropped_records++;
+        return;
+    }
+    pending_records[(pending_head + pending_count) % CONTACT_PENDING_CAPACITY] = *record;
+    pending_count++;
+}
+
+// Linear probe for the pair. Returns the slot holding it, or the empty slot where it
+// would go, or -1 if the table is full and the pair is absent.
+static int find_slot(int id1, int id2) {
+    unsigned slot = contact_hash(id1, id2);
+    for (int probe = 0; probe < CONTACT_TABLE_SIZE; ++probe) {
+        ContactEpisode* e = &contact_table[slot];
+        if (!e->in_use || (e->drone_id1 == id1 && e->drone_id2 == id2)) return (int)slot;
+        slot = (slot + 1) & (CONTACT_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+// Removes the entry at `slot`, shifting later entries of the same probe run back
+// so lookups never need tombstones.
+static void remove_slot(unsigned slot) {
+    unsigned hole = slot;
+    unsigned next = (slot + 1) & (CONTACT_TABLE_SIZE - 1);
+    while (contact_table[next].in_use) {
+        unsigned home = contact_hash(contact_table[next].drone_id1, contact_table[next].drone_id2);
+        // Move the entry into the hole unless its home lies cyclically in (hole, next].
+        int home_after_hole = (next > hole) ? (home > hole && home <= next)
+                                            : (home > hole || home <= next);
+        if (!home_after_hole) {
+            contact_table[hole] = contact_table[next];
+            hole = next;
+        }
+        next = (next + 1) & (CONTACT_TABLE_SIZE - 1);
+    }
+    contact_table[hole].in_use = 0;
+    contact_table_used--;
+}
+
+static void close_episode(unsigned slot) {
+    const ContactEpisode* e = &contact_table[slot];
+    ContactRecord record = {
+        .type = CONTACT_EPISODE_END,
+        .drone_id1 = e->drone_id1, .drone_id2 = e->drone_id2,
+        .start_step = e->start_step, .end_step = e->last_step,
+        .x = e->last_x, .y = e->last_y, .z = e->last_z,
+        .cell_changes = e->cell_changes
+    };
+    push_record(&record);
+    remove_slot(slot);
+}
+
+void contact_tracker_reset(void) {
+    memset(contact_table, 0, sizeof(contact_table));
+    contact_table_used = 0;
+    pending_head = 0;
+    pending_count = 0;
+    dropped_records = 0;
+}
+
+void contact_tracker_record_step(int drone_id1, int drone_id2, int x, int y, int z, int time_step) {
+    ContactRecord record = {
+        .type = CONTACT_STEP,
+        .drone_id1 = drone_id1, .drone_id2 = drone_id2,
+        .start_step = time_step, .end_step = time_step,
+        .x = x, .y = y, .z = z,
+        .cell_changes = 0
+    };
+    push_record(&record);
+}
+
+int contact_tracker_observe(int drone_id1, int drone_id2, int x, int y, int z, int time_step) {
+    if (drone_id1 > drone_id2) {
+        int tmp = drone_id1; drone_id1 = drone_id2; drone_id2 = tmp;
+    }
+
+    int slot = find_slot(drone_id1, drone_id2);
+    if (slot < 0) {
+        // Table exhausted: fall back to a per-step record rather than losing the event.
+        contact_tracker_record_step(drone_id1, drone_id2, x, y, z, time_step);
+        return 1;
+    }
+
+    ContactEpisode* e = &contact_table[slot];
+    if (e->in_use) {
+        if (e->last_x != x || e->last_y != y || e->last_z != z) e->cell_changes++; // A->B->A counts 2
+        e->last_step = time_step;
+        e->last_x = x; e->last_y = y; e->last_z = z;
+        return 0;
+    }
+
+    *e = (ContactEpisode){
+        .in_use = 1,
+        .drone_id1 = drone_id1, .drone_id2 = drone_id2,
+        .start_step = time_step, .last_step = time_step,
+        .start_x = x, .start_y = y, .start_z = z,
+        .last_x = x, .last_y = y, .last_z = z,
+        .cell_changes = 0
+    };
+    contact_table_used++;
+
+    ContactRecord record = {
+        .type = CONTACT_EPISODE_START,
+        .drone_id1 = drone_id1, .drone_id2 = drone_id2,
+        .start_step = time_step, .end_step = time_step,
+        .x = x, .y = y, .z = z,
+        .cell_changes = 0
+    };
+    push_record(&record);
+    return 1;
+}
+
+int contact_tracker_end_step(int time_step) {
+    int closed = 0;
+    unsigned slot = 0;
+    // remove_slot may pull a later entry back into `slot`, so only advance when nothing was removed.
+    while (slot < CONTACT_TABLE_SIZE && contact_table_used > 0) {
+        if (contact_table[slot].in_use && contact_table[slot].last_step < time_step) {
+            close_episode(slot);
+            closed++;
+        } else {
+            slot++;
+        }
+    }
+    return closed;
+}
+
+int contact_tracker_flush(void) {
+    int closed = 0;
+    for (unsigned slot = 0; slot < CONTACT_TABLE_SIZE && contact_table_used > 0; ) {
+        if (contact_table[slot].in_use) {
+            close_episode(slot);
+            closed++;
+        } else {
+            slot++;
+        }
+    }
+    return closed;
+}
+
+int contact_tracker_pop(ContactRecord* out) {
+    if (pending_count == 0) return 0;
+    *out = pending_records[pending_head];
+    pending_head = (pending_head + 1) % CONTACT_PENDING_CAPACITY;
+    pending_count--;
+    return 1;
+}
+
+int contact_tracker_dropped_count(void) {
+    return dropped_records;
+}
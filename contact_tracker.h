@@ -0,0 +1,51 @@
+// contact_tracker.h
+#ifndef CONTACT_TRACKER_H
+#define CONTACT_TRACKER_H
+
+#include "drone_simulation.h" // For MAX_DRONES
+
+// Open-addressing table of active contacts, keyed by drone pair. Sized as a power
+// of two comfortably above the MAX_DRONES * (MAX_DRONES - 1) / 2 possible pairs.
+#define CONTACT_TABLE_SIZE 128
+// Records waiting for the report thread. When full, new records are dropped and counted.
+#define CONTACT_PENDING_CAPACITY 256
+
+typedef enum {
+    CONTACT_STEP,          // Per-step collision (per-step counting mode)
+    CONTACT_EPISODE_START, // A pair came into contact
+    CONTACT_EPISODE_END    // A pair separated (or the simulation ended while in contact)
+} ContactRecordType;
+
+// A collision record handed from the collision thread to the report thread.
+typedef struct {
+    ContactRecordType type;
+    int drone_id1, drone_id2;
+    int start_step, end_step;   // First and last step in contact (equal for CONTACT_STEP)
+    int x, y, z;                // First contact cell (START/STEP) or last contact cell (END)
+    int cell_changes;           // Times the shared cell changed during the episode (0 if it never moved)
+} ContactRecord;
+
+// Clears all active contacts and pending records.
+void contact_tracker_reset(void);
+
+// Per-step counting mode: queues one CONTACT_STEP record.
+void contact_tracker_record_step(int drone_id1, int drone_id2, int x, int y, int z, int time_step);
+
+// Episode mode: notes that the pair shares cell (x, y, z) at `time_step`.
+// Returns 1 if this opened a new episode (a START record was queued), 0 if it extended one.
+int contact_tracker_observe(int drone_id1, int drone_id2, int x, int y, int z, int time_step);
+
+// Episode mode: closes every episode that was not observed at `time_step`, queueing END records.
+// Call once per step after all observations. Returns the number of episodes closed.
+int contact_tracker_end_step(int time_step);
+
+// Closes every episode still open (end of simulation). Returns the number closed.
+int contact_tracker_flush(void);
+
+// Pops the oldest pending record into `out`. Returns 1 if one was available, 0 otherwise.
+int contact_tracker_pop(ContactRecord* out);
+
+// Number of records dropped because the pending queue was full.
+int contact_tracker_dropped_count(void);
+
+#endif // CONTACT_TRACKER_H
@@ -0,0 +1,126 @@
+// contact_tracker_check.c
+// Direct checks of the contact tracker's episode bookkeeping and hash table.
+// Includes contact_tracker.c so the static table and remove_slot can be inspected.
+// Exits non-zero if any check fails.
+// Usage: ./contact_tracker_check
+#include "contact_tracker.c"
+
+static int failures = 0;
+
+static void expect(int condition, const char* what) {
+    printf("  %-62s %s\n", what, condition ? "PASS" : "FAIL");
+    if (!condition) failures++;
+}
+
+// Finds a pair (id1 < id2, both above `min_id`) whose home slot is `home`.
+static int pair_with_home(unsigned home, int min_id, int* id1, int* id2) {
+    for (int a = min_id + 1; a < 4096; ++a) {
+        for (int b = a + 1; b < a + 64; ++b) {
+            if (contact_hash(a, b) == home) {
+                *id1 = a;
+                *id2 = b;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void place(unsigned slot, int id1, int id2) {
+    contact_table[slot] = (ContactEpisode){ .in_use = 1, .drone_id1 = id1, .drone_id2 = id2 };
+    contact_table_used++;
+}
+
+static int slot_holds(unsigned slot, int id1, int id2) {
+    return contact_table[slot].in_use && contact_table[slot].drone_id1 == id1 && contact_table[slot].drone_id2 == id2;
+}
+
+static void check_cell_changes(void) {
+    ContactRecord record;
+    contact_tracker_reset();
+    contact_tracker_observe(1, 2, 0, 0, 0, 1); // A
+    contact_tracker_observe(1, 2, 0, 0, 0, 2); // A again
+    contact_tracker_observe(1, 2, 1, 0, 0, 3); // B
+    contact_tracker_observe(1, 2, 0, 0, 0, 4); // back to A
+    contact_tracker_end_step(4);
+    contact_tracker_end_step(5);
+    contact_tracker_pop(&record);
+    int closed = contact_tracker_pop(&record) && record.type == CONTACT_EPISODE_END;
+    expect(closed && record.cell_changes == 2, "A->A->B->A episode reports 2 cell changes");
+    expect(closed && record.start_step == 1 && record.end_step == 4, "episode spans Time Steps 1-4");
+}
+
+// Entries X (home 127) at 127, Y (home 127) wrapped to 0, Z (home 0) at 1.
+// Removing X must pull Y back to 127 and Z back to 0.
+static void check_backshift_across_wrap(void) {
+    int x1, x2, y1, y2, z1, z2;
+    contact_tracker_reset();
+    if (!pair_with_home(CONTACT_TABLE_SIZE - 1, 0, &x1, &x2) || !pair_with_home(CONTACT_TABLE_SIZE - 1, x1, &y1, &y2) ||
+        !pair_with_home(0, 0, &z1, &z2)) {
+        expect(0, "found pairs for the wraparound layout");
+        return;
+    }
+    place(CONTACT_TABLE_SIZE - 1, x1, x2);
+    place(0, y1, y2);
+    place(1, z1, z2);
+
+    remove_slot(CONTACT_TABLE_SIZE - 1);
+    expect(slot_holds(CONTACT_TABLE_SIZE - 1, y1, y2), "wrapped entry moves back from 0 to its home 127");
+    expect(slot_holds(0, z1, z2), "entry homed at 0 moves back from 1 to 0");
+    expect(!contact_table[1].in_use && contact_table_used == 2, "vacated slot 1 is empty, 2 entries left");
+    expect(find_slot(y1, y2) == CONTACT_TABLE_SIZE - 1 && find_slot(z1, z2) == 0, "both remaining pairs are found");
+    expect(find_slot(x1, x2) == 1, "removed pair is absent (probe stops at the hole)");
+}
+
+// Entries X (home 127) at 127, Y (home 0) at 0, Z (home 127) wrapped to 1.
+// Removing X leaves Y at its home and moves Z over it to 127.
+static void check_backshift_skips_home_entries(void) {
+    int x1, x2, y1, y2, z1, z2;
+    contact_tracker_reset();
+    if (!pair_with_home(CONTACT_TABLE_SIZE - 1, 0, &x1, &x2) || !pair_with_home(0, 0, &y1, &y2) ||
+        !pair_with_home(CONTACT_TABLE_SIZE - 1, x1, &z1, &z2)) {
+        expect(0, "found pairs for the skip layout");
+        return;
+    }
+    place(CONTACT_TABLE_SIZE - 1, x1, x2);
+    place(0, y1, y2);
+    place(1, z1, z2);
+
+    remove_slot(CONTACT_TABLE_SIZE - 1);
+    expect(slot_holds(0, y1, y2), "entry already at its home 0 stays");
+    expect(slot_holds(CONTACT_TABLE_SIZE - 1, z1, z2), "entry homed at 127 moves from 1 past 0 to 127");
+    expect(!contact_table[1].in_use && contact_table_used == 2, "vacated slot 1 is empty, 2 entries left");
+    expect(find_slot(y1, y2) == 0 && find_slot(z1, z2) == CONTACT_TABLE_SIZE - 1, "both remaining pairs are found");
+}
+
+// Episodes closed by end_step while others in the same probe run stay open.
+static void check_end_step_keeps_live_run(void) {
+    int ids[4][2];
+    int min_id = 0;
+    contact_tracker_reset();
+    for (int i = 0; i < 4; ++i) {
+        if (!pair_with_home(CONTACT_TABLE_SIZE - 2, min_id, &ids[i][0], &ids[i][1])) {
+            expect(0, "found pairs for the end_step layout");
+            return;
+        }
+        min_id = ids[i][0];
+        contact_tracker_observe(ids[i][0], ids[i][1], i, 0, 0, 1);
+    }
+    // Pairs 0 and 2 separate; 1 and 3 stay in contact.
+    contact_tracker_observe(ids[1][0], ids[1][1], 1, 0, 0, 2);
+    contact_tracker_observe(ids[3][0], ids[3][1], 3, 0, 0, 2);
+    int closed = contact_tracker_end_step(2);
+    expect(closed == 2 && contact_table_used == 2, "end_step closes exactly the 2 separated pairs");
+    expect(contact_tracker_observe(ids[1][0], ids[1][1], 1, 0, 0, 3) == 0 &&
+           contact_tracker_observe(ids[3][0], ids[3][1], 3, 0, 0, 3) == 0, "open episodes are still found after the shifts");
+}
+
+int main(void) {
+    printf("Contact tracker (table size %d)\n", CONTACT_TABLE_SIZE);
+    check_cell_changes();
+    check_backshift_across_wrap();
+    check_backshift_skips_home_entries();
+    check_end_step_keeps_live_run();
+    printf("%s\n", failures == 0 ? "All checks passed." : "Some checks FAILED.");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
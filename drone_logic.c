@@ -1,5 +1,7 @@
 // drone_logic.c
 #include "drone_simulation.h"
+#include "latency_monitor.h"
+#include "shm_segment.h"
 
 // Defined globally for access by signal handler and main logic
 static volatile sig_atomic_t collision_signal_received = 0;
@@ -12,12 +14,13 @@ void signal_handler_collision_child(int signum) {
 
 void drone_child_process(int drone_index, Drone initial_drone_config) {
     // --- Attach to Shared Memory and Semaphores ---
-    SharedMemoryLayout *local_shared_mem;
-    int shm_fd = shm_open(SHM_NAME, O_RDWR, 0666);
-    if (shm_fd == -1) { perror("DRONE_LOGIC: shm_open child"); exit(EXIT_FAILURE); }
-    local_shared_mem = mmap(0, sizeof(SharedMemoryLayout), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    if (local_shared_mem == MAP_FAILED) { perror("DRONE_LOGIC: mmap child"); exit(EXIT_FAILURE); }
-    close(shm_fd);
+    // main keeps numa_bind only if each drone's slot pages were bound to this drone's node.
+    if (sim_options.shm.numa_bind && !shm_segment_pin_to_partition_node(drone_index, num_sim_drones)) {
+        perror("DRONE_LOGIC: NUMA pinning child"); // Not fatal: the drone just runs unpinned
+    }
+    ShmSegment shm_view;
+    if (!shm_segment_attach(&shm_segment, &shm_view)) { perror("DRONE_LOGIC: shm attach child"); exit(EXIT_FAILURE); }
+    SharedMemoryLayout *local_shared_mem = shm_view.addr;
 
     char sem_name[BUFFER_SIZE];
     snprintf(sem_name, BUFFER_SIZE, "%s%d", SEM_PARENT_PREFIX, drone_index);
@@ -83,6 +86,7 @@ void drone_child_process(int drone_index, Drone initial_drone_config) {
         }
 
         // --- US364: Signal parent that this step is complete ---
+        local_shared_mem->drones[drone_index].ack_time_ns = latency_now_ns(); // For parent's latency tracking
         sem_post(sem_parent); // Signal parent: "I'm done with this step"
 
         if (local_shared_mem->drones[drone_index].finished) {
@@ -93,6 +97,6 @@ void drone_child_process(int drone_index, Drone initial_drone_config) {
     // --- Cleanup ---
     sem_close(sem_parent);
     sem_close(sem_child);
-    munmap(local_shared_mem, sizeof(SharedMemoryLayout));
+    shm_segment_detach(&shm_view);
     exit(EXIT_SUCCESS);
 }
\ No newline at end of file
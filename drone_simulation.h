@@ -25,6 +25,7 @@
 #define MAX_INSTRUCTION_LEN 10
 #define BUFFER_SIZE 256
 #define REPORT_FILENAME "simulation_report.txt"
+#define STATS_CSV_FILENAME "simulation_stats.csv"
 #define COLLISION_THRESHOLD 3
 #define MAX_TIME_STEPS 100
 
@@ -53,6 +54,7 @@ typedef struct {
     int active;
     int instruction_executed_index;
     int terminate_flag;
+    long long ack_time_ns;   // CLOCK_MONOTONIC time the child finished its last step
 } DroneSharedState;
 
 // Layout of the entire shared memory segment
@@ -68,6 +70,8 @@ typedef struct {
     time_t timestamp;
     int drone_id1, drone_id2;
     int x, y, z;
+    int end_step;        // Last step of the contact episode (== time_step in per-step mode)
+    int cell_changes;    // Times the shared cell changed during the episode (0 in per-step mode)
 } CollisionEvent;
 
 // Structure representing a single drone's configuration
@@ -81,6 +85,50 @@ typedef struct {
     sem_t *sem_child_can_act;
 } Drone;
 
+// What the simulation loop does with a drone that misses the step deadline
+typedef enum {
+    LAGGARD_WAIT,        // Log the miss and keep waiting (lockstep is preserved)
+    LAGGARD_SKIP,        // Move on; the drone sits out steps until its response arrives
+    LAGGARD_DEACTIVATE   // Mark the drone inactive and stop driving it
+} LaggardPolicy;
+
+// How the shared-memory segment is backed and placed (see shm_segment.c)
+typedef struct {
+    int huge_pages;   // Back the segment with hugetlb pages, falling back to THP advice
+    int prefault;     // Populate all pages up front (parent) and at attach (children)
+    int numa_bind;    // Bind each drone's slots to the NUMA node its child is pinned to
+} ShmSegmentOptions;
+
+// --first-conflict validation mode (see plan_validator.c): what ends a validation run.
+typedef enum {
+    FIRST_CONFLICT_OFF,        // Normal simulation
+    FIRST_CONFLICT_ANY,        // Stop at the first collision
+    FIRST_CONFLICT_THRESHOLD   // Stop when the collision count reaches COLLISION_THRESHOLD
+} FirstConflictMode;
+
+// Console monitoring options (see ui_display.c)
+typedef struct {
+    int diff_renderer;               // 1: incremental ANSI renderer; 0: full grid printout every step
+    int view_x, view_y;              // World (x, y) shown in the viewport's bottom-left cell
+    int view_width, view_height;     // Viewport size in terminal cells (0 = GRID_WIDTH/GRID_HEIGHT)
+    int zoom;                        // World cells per terminal cell along x and y (>= 1)
+    int z_slice;                     // 1: only drones with z_min <= z <= z_max are drawn
+    int z_min, z_max;
+    int max_fps;                     // Frame-rate cap for the diff renderer (0 = every step)
+} DisplayOptions;
+
+// Run-time options parsed from the command line in main_controller.c
+typedef struct {
+    const char* csv_filename;
+    int per_step_collisions;   // 1: count/log every colliding step; 0: one record per contact episode
+    int step_deadline_ms;      // Per-step response deadline; 0 waits indefinitely
+    LaggardPolicy laggard_policy;
+    ShmSegmentOptions shm;
+    DisplayOptions display;
+    FirstConflictMode first_conflict;  // Validate plans only, without forking drones or writing the report
+    const char* plan_list_filename;    // --plan-list: file of plan paths ("-" = stdin) for validation
+} SimulationOptions;
+
 
 // --- Global Variables ---
 extern Drone sim_drones[MAX_DRONES];
@@ -89,8 +137,8 @@ extern FILE *report_file;
 extern int total_collisions_count;
 extern CollisionEvent collision_log[MAX_DRONES * MAX_TIME_STEPS];
 extern int collision_log_index;
-extern int drone_positions_history[MAX_TIME_STEPS][MAX_DRONES][3];
 extern SharedMemoryLayout *shared_mem;
+extern SimulationOptions sim_options;
 
 // --- Function Prototypes ---
 
@@ -111,6 +159,12 @@ void log_drone_update_to_report(const DroneSharedState* update, CommandType cmd_
 void log_drone_finish_to_report(const DroneSharedState* update);
 void log_error_to_report(const char* error_message);
 void log_collision_to_report(int drone_id1, int drone_id2, int x, int y, int z, int time_step);
+void log_contact_episode_start_to_report(int drone_id1, int drone_id2, int x, int y, int z, int time_step);
+void log_contact_episode_end_to_report(int drone_id1, int drone_id2, int x, int y, int z,
+                                       int start_step, int end_step, int cell_changes);
+void log_deadline_miss_to_report(int drone_id, int time_step, const char* action);
+// Closes a skipped drone's outstanding period: answered at `time_step`, or never if `time_step` < 0.
+void log_late_response_to_report(int drone_id, int missed_step, int time_step);
 void log_simulation_summary_to_report(int final_time_step, int simulation_failed_status);
 void close_report(void);
 
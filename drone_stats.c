@@ -0,0 +1,113 @@
+// drone_stats.c
+#include "drone_stats.h"
+#include <math.h>
+
+// Written only by the simulation loop thread.
+typedef struct {
+    int32_t distance;
+    int32_t steps_in_band[ALTITUDE_BAND_COUNT];
+    int32_t last_x, last_y, last_z;
+} MotionAccumulator;
+
+// Written only by the collision detection thread.
+typedef struct {
+    int32_t collisions;
+    int32_t nearest_index;       // -1 until the first comparison
+    long long min_separation_sq;
+} ProximityAccumulator;
+
+static MotionAccumulator motion_acc[MAX_DRONES];
+static ProximityAccumulator proximity_acc[MAX_DRONES];
+
+static int altitude_band(int z) {
+    if (z < 0) return 0;
+    int band = z / ALTITUDE_BAND_HEIGHT;
+    return band < ALTITUDE_BAND_COUNT ? band : ALTITUDE_BAND_COUNT - 1;
+}
+
+static void update_nearest(int drone_index, int other_index, long long distance_sq) {
+    ProximityAccumulator* acc = &proximity_acc[drone_index];
+    if (acc->nearest_index < 0 || distance_sq < acc->min_separation_sq) {
+        acc->min_separation_sq = distance_sq;
+        acc->nearest_index = other_index;
+    }
+}
+
+void drone_stats_reset(const DroneSharedState drones[], int drone_count) {
+    memset(motion_acc, 0, sizeof(motion_acc));
+    memset(proximity_acc, 0, sizeof(proximity_acc));
+    for (int i = 0; i < MAX_DRONES; ++i) proximity_acc[i].nearest_index = -1;
+    for (int i = 0; i < drone_count && i < MAX_DRONES; ++i) {
+        motion_acc[i].last_x = drones[i].x;
+        motion_acc[i].last_y = drones[i].y;
+        motion_acc[i].last_z = drones[i].z;
+    }
+}
+
+void drone_stats_record_motion(int drone_index, const DroneSharedState* state) {
+    if (drone_index < 0 || drone_index >= MAX_DRONES) return;
+    MotionAccumulator* acc = &motion_acc[drone_index];
+    acc->distance += abs(state->x - acc->last_x) + abs(state->y - acc->last_y) + abs(state->z - acc->last_z);
+    acc->steps_in_band[altitude_band(state->z)]++;
+    acc->last_x = state->x;
+    acc->last_y = state->y;
+    acc->last_z = state->z;
+}
+
+void drone_stats_record_separation(int drone_index1, int drone_index2, long long distance_sq) {
+    if (drone_index1 < 0 || drone_index1 >= MAX_DRONES || drone_index2 < 0 || drone_index2 >= MAX_DRONES) return;
+    update_nearest(drone_index1, drone_index2, distance_sq);
+    update_nearest(drone_index2, drone_index1, distance_sq);
+}
+
+void drone_stats_record_collision(int drone_index) {
+    if (drone_index >= 0 && drone_index < MAX_DRONES) proximity_acc[drone_index].collisions++;
+}
+
+void drone_stats_merge(int drone_index, DroneStats* out) {
+    memset(out, 0, sizeof(*out));
+    out->min_separation = -1.0;
+    out->nearest_drone_id = -1;
+    if (drone_index < 0 || drone_index >= MAX_DRONES) return;
+
+    const MotionAccumulator* motion = &motion_acc[drone_index];
+    const ProximityAccumulator* proximity = &proximity_acc[drone_index];
+    out->id = sim_drones[drone_index].id;
+    out->distance_travelled = motion->distance;
+    memcpy(out->steps_in_band, motion->steps_in_band, sizeof(out->steps_in_band));
+    out->collisions = proximity->collisions;
+    if (proximity->nearest_index >= 0) {
+        out->min_separation = sqrt((double)proximity->min_separation_sq);
+        out->nearest_drone_id = sim_drones[proximity->nearest_index].id;
+    }
+}
+
+int drone_stats_write_csv(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        perror("DRONE_STATS: Error opening statistics CSV");
+        return 0;
+    }
+
+    fprintf(file, "drone_id,distance_travelled,collisions");
+    for (int b = 0; b < ALTITUDE_BAND_COUNT; ++b) {
+        if (b < ALTITUDE_BAND_COUNT - 1) {
+            fprintf(file, ",steps_z%d_%d", b * ALTITUDE_BAND_HEIGHT, (b + 1) * ALTITUDE_BAND_HEIGHT - 1);
+        } else {
+            fprintf(file, ",steps_z%d_up", b * ALTITUDE_BAND_HEIGHT);
+        }
+    }
+    fprintf(file, ",min_separation,nearest_drone_id\n");
+
+    for (int i = 0; i < num_sim_drones; ++i) {
+        DroneStats stats;
+        drone_stats_merge(i, &stats);
+        fprintf(file, "%d,%d,%d", stats.id, stats.distance_travelled, stats.collisions);
+        for (int b = 0; b < ALTITUDE_BAND_COUNT; ++b) fprintf(file, ",%d", stats.steps_in_band[b]);
+        if (stats.nearest_drone_id >= 0) fprintf(file, ",%.3f,%d\n", stats.min_separation, stats.nearest_drone_id);
+        else fprintf(file, ",,\n");
+    }
+
+    fclose(file);
+    return 1;
+}
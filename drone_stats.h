@@ -0,0 +1,43 @@
+// drone_stats.h
+#ifndef DRONE_STATS_H
+#define DRONE_STATS_H
+
+#include <stdint.h>
+#include "drone_simulation.h" // For DroneSharedState and MAX_DRONES
+
+// Altitude bands for the time-in-band statistic: [0, 5), [5, 10), [10, 15), [15, ...).
+// Altitudes below 0 count towards the lowest band.
+#define ALTITUDE_BAND_HEIGHT 5
+#define ALTITUDE_BAND_COUNT 4
+
+// Final per-drone statistics, merged from the per-thread accumulators.
+typedef struct {
+    int id;
+    int distance_travelled;               // Unit moves executed (Manhattan distance along the path)
+    int collisions;                       // Collisions the drone took part in (as counted by the run)
+    int steps_in_band[ALTITUDE_BAND_COUNT];
+    double min_separation;                // Closest distance to any other drone in flight; -1 if never compared
+    int nearest_drone_id;                 // Drone at min_separation; -1 if never compared
+} DroneStats;
+
+// Clears all accumulators and seeds last positions from the initial states.
+void drone_stats_reset(const DroneSharedState drones[], int drone_count);
+
+// Simulation loop thread: drone i acknowledged a step at `state`. O(1).
+void drone_stats_record_motion(int drone_index, const DroneSharedState* state);
+
+// Collision thread: squared distance between drones i and j this step, for pairs where
+// both drones are still in flight (or landed this step). O(1) per pair, so O(n) per
+// drone per step; it rides on the pairwise scan the collision check already performs.
+void drone_stats_record_separation(int drone_index1, int drone_index2, long long distance_sq);
+
+// Collision thread: a counted collision involving drone i.
+void drone_stats_record_collision(int drone_index);
+
+// Merges the accumulators for drone i into `out`.
+void drone_stats_merge(int drone_index, DroneStats* out);
+
+// Writes the merged statistics of all drones as CSV. Returns 1 on success, 0 on failure.
+int drone_stats_write_csv(const char* filename);
+
+#endif // DRONE_STATS_H
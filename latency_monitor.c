@@ -0,0 +1,100 @@
+// latency_monitor.c
+#define _GNU_SOURCE // For clock_gettime under -std=c11
+#include "latency_monitor.h"
+
+typedef struct {
+    long long ns;
+    int censored;   // 1: no response; `ns` is how long the parent waited
+} LatencySample;
+
+static LatencySample latency_samples[MAX_DRONES][LATENCY_MAX_SAMPLES];
+static int latency_sample_count[MAX_DRONES];
+static int deadline_miss_count[MAX_DRONES];
+static int skipped_step_count[MAX_DRONES];
+static int deactivated_flag[MAX_DRONES];
+
+long long latency_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void latency_monitor_reset(void) {
+    memset(latency_sample_count, 0, sizeof(latency_sample_count));
+    memset(deadline_miss_count, 0, sizeof(deadline_miss_count));
+    memset(skipped_step_count, 0, sizeof(skipped_step_count));
+    memset(deactivated_flag, 0, sizeof(deactivated_flag));
+}
+
+static void add_sample(int drone_index, long long latency_ns, int censored) {
+    if (drone_index < 0 || drone_index >= MAX_DRONES) return;
+    if (latency_sample_count[drone_index] >= LATENCY_MAX_SAMPLES) return;
+    if (latency_ns < 0) latency_ns = 0;
+    latency_samples[drone_index][latency_sample_count[drone_index]++] = (LatencySample){ latency_ns, censored };
+}
+
+void latency_monitor_record(int drone_index, long long latency_ns) {
+    add_sample(drone_index, latency_ns, 0);
+}
+
+void latency_monitor_record_censored(int drone_index, long long waited_ns) {
+    add_sample(drone_index, waited_ns, 1);
+}
+
+void latency_monitor_note_deadline_miss(int drone_index) {
+    if (drone_index >= 0 && drone_index < MAX_DRONES) deadline_miss_count[drone_index]++;
+}
+
+void latency_monitor_note_skipped_step(int drone_index) {
+    if (drone_index >= 0 && drone_index < MAX_DRONES) skipped_step_count[drone_index]++;
+}
+
+void latency_monitor_note_deactivated(int drone_index) {
+    if (drone_index >= 0 && drone_index < MAX_DRONES) deactivated_flag[drone_index] = 1;
+}
+
+static int compare_samples(const void* a, const void* b) {
+    long long x = ((const LatencySample*)a)->ns, y = ((const LatencySample*)b)->ns;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank index (0-based) of percentile `pct` over n sorted samples.
+static int percentile_index(int n, int pct) {
+    int rank = (pct * n + 99) / 100; // ceil(pct/100 * n)
+    if (rank < 1) rank = 1;
+    return rank - 1;
+}
+
+void latency_monitor_summary(int drone_index, LatencySummary* out) {
+    memset(out, 0, sizeof(*out));
+    if (drone_index < 0 || drone_index >= MAX_DRONES) return;
+
+    int n = latency_sample_count[drone_index];
+    out->samples = n;
+    out->deadline_misses = deadline_miss_count[drone_index];
+    out->skipped_steps = skipped_step_count[drone_index];
+    out->deactivated = deactivated_flag[drone_index];
+    if (n == 0) return;
+
+    LatencySample sorted[LATENCY_MAX_SAMPLES];
+    memcpy(sorted, latency_samples[drone_index], (size_t)n * sizeof(LatencySample));
+    qsort(sorted, (size_t)n, sizeof(LatencySample), compare_samples);
+    int p50 = percentile_index(n, 50);
+    int p99 = percentile_index(n, 99);
+    out->p50_ns = sorted[p50].ns;
+    out->p99_ns = sorted[p99].ns;
+    out->max_ns = sorted[n - 1].ns;
+
+    // A censored sample at or below a rank could really lie above it, so that value is only a lower bound.
+    int lowest_censored = -1;
+    for (int k = 0; k < n; ++k) {
+        if (!sorted[k].censored) continue;
+        out->censored++;
+        if (lowest_censored < 0) lowest_censored = k;
+    }
+    if (lowest_censored >= 0) {
+        out->p50_lower_bound = lowest_censored <= p50;
+        out->p99_lower_bound = lowest_censored <= p99;
+        out->max_lower_bound = 1;
+    }
+}
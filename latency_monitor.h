@@ -0,0 +1,45 @@
+// latency_monitor.h
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include "drone_simulation.h" // For MAX_DRONES and MAX_TIME_STEPS
+
+// Samples kept per drone: at most one response per time step.
+#define LATENCY_MAX_SAMPLES MAX_TIME_STEPS
+
+// Per-drone response statistics, computed on demand for the summary.
+typedef struct {
+    int samples;
+    long long p50_ns;
+    long long p99_ns;
+    long long max_ns;
+    int deadline_misses;   // Steps where the response arrived after the deadline (or never)
+    int skipped_steps;     // Steps the drone sat out because a previous response was outstanding
+    int deactivated;       // 1 if the laggard policy took the drone out of the simulation
+    int censored;          // Samples for responses that never arrived (recorded at the time waited)
+    int p50_lower_bound;   // 1 if a censored sample makes the value only a lower bound
+    int p99_lower_bound;
+    int max_lower_bound;
+} LatencySummary;
+
+// CLOCK_MONOTONIC in nanoseconds. Comparable across the parent and child processes.
+long long latency_now_ns(void);
+
+// Clears all samples and counters.
+void latency_monitor_reset(void);
+
+// Records the time between "go" and acknowledgment for one step of a drone.
+void latency_monitor_record(int drone_index, long long latency_ns);
+
+// Records a response that never arrived after `waited_ns` (at least the deadline). Its true
+// latency is unknown but no smaller, so percentiles it affects are reported as lower bounds.
+void latency_monitor_record_censored(int drone_index, long long waited_ns);
+
+void latency_monitor_note_deadline_miss(int drone_index);
+void latency_monitor_note_skipped_step(int drone_index);
+void latency_monitor_note_deactivated(int drone_index);
+
+// Fills `out` with percentiles (nearest rank) and counters for the drone.
+void latency_monitor_summary(int drone_index, LatencySummary* out);
+
+#endif // LATENCY_MONITOR_H
@@ -1,13 +1,30 @@
 // main_controller.c
+#define _GNU_SOURCE // For sem_timedwait, clock_gettime, kill, ftruncate and usleep under -std=c11
 #include "drone_simulation.h"
 #include "ui_display.h"
+#include "contact_tracker.h"
+#include "latency_monitor.h"
+#include "position_history.h"
+#include "drone_stats.h"
+#include "shm_segment.h"
+#include "plan_validator.h"
+#include <errno.h>
+#include <stddef.h> // For offsetof
 
 // Define global variables
 Drone sim_drones[MAX_DRONES];
 int num_sim_drones = 0;
 int total_collisions_count = 0;
-int drone_positions_history[MAX_TIME_STEPS][MAX_DRONES][3];
+PositionHistory position_history;
 SharedMemoryLayout *shared_mem = NULL;
+ShmSegment shm_segment;
+SimulationOptions sim_options = {
+    .csv_filename = "drones_flight_plan.csv",
+    .per_step_collisions = 0,
+    .step_deadline_ms = 1000,
+    .laggard_policy = LAGGARD_WAIT,
+    .display = { .zoom = 1, .max_fps = DIFF_RENDERER_DEFAULT_FPS }
+};
 
 // Thread management and synchronization variables
 pthread_t sim_thread_id, collision_thread_id, report_thread_id;
@@ -19,12 +36,14 @@ pthread_cond_t collision_cond = PTHREAD_COND_INITIALIZER;
 int current_time_step = 1;
 int step_ready_for_collision_check = 0;
 int collision_event_occurred = 0;
+int simulation_loop_finished = 0; // Set once the simulation thread's end-of-run work is done
 int overall_simulation_status_code = 0;
 
-typedef struct {
-    int drone_id1, drone_id2, x, y, z, time_step;
-} CollisionInfo;
-CollisionInfo last_collision_info;
+// Per-drone step timing for deadline handling (owned by the simulation loop thread)
+long long drone_step_posted_ns[MAX_DRONES];
+int drone_ack_outstanding[MAX_DRONES];
+int drone_ack_missed_step[MAX_DRONES]; // Step whose response is outstanding (skip/deactivate)
+int drone_last_ack_step[MAX_DRONES];   // Step of the last processed response; read by the collision thread
 
 
 void cleanup_simulation_resources() {
@@ -37,60 +56,164 @@ void cleanup_simulation_resources() {
         snprintf(sem_name, BUFFER_SIZE, "%s%d", SEM_CHILD_PREFIX, i);
         sem_unlink(sem_name);
     }
-    if (shared_mem) {
-        munmap(shared_mem, sizeof(SharedMemoryLayout));
-    }
-    shm_unlink(SHM_NAME);
+    shm_segment_destroy(&shm_segment);
+    shared_mem = NULL;
+    position_history_free(&position_history);
     pthread_mutex_destroy(&data_mutex);
     pthread_cond_destroy(&step_cond);
     pthread_cond_destroy(&collision_cond);
     printf("MAIN_CONTROLLER: All simulation resources cleaned up.\n");
 }
 
+// Reads a drone's acknowledged step from shared memory, records its response latency
+// and logs the update. Returns 1 if the drone finished its flight plan.
+static int process_drone_ack(int i) {
+    latency_monitor_record(i, shared_mem->drones[i].ack_time_ns - drone_step_posted_ns[i]);
+    drone_stats_record_motion(i, &shared_mem->drones[i]);
+    drone_last_ack_step[i] = current_time_step;
+    if (shared_mem->drones[i].finished) {
+        shared_mem->drones[i].active = 0;
+        log_drone_finish_to_report(&shared_mem->drones[i]);
+        return 1;
+    }
+    log_drone_update_to_report(&shared_mem->drones[i], sim_drones[i].instructions[shared_mem->drones[i].instruction_executed_index]);
+    return 0;
+}
+
+// Waits for drone i's acknowledgment until `deadline` (CLOCK_REALTIME), or indefinitely
+// when no deadline is configured. Returns 1 if it arrived, 0 on timeout.
+static int wait_for_drone_ack(int i, const struct timespec* deadline) {
+    int rc;
+    if (sim_options.step_deadline_ms <= 0) {
+        while ((rc = sem_wait(sim_drones[i].sem_parent_can_read)) == -1 && errno == EINTR) {}
+        return rc == 0;
+    }
+    while ((rc = sem_timedwait(sim_drones[i].sem_parent_can_read, deadline)) == -1 && errno == EINTR) {}
+    return rc == 0;
+}
+
 void* simulation_loop_thread(void* arg) {
     int active_drones_count = num_sim_drones;
+    int posted_this_step[MAX_DRONES];
 
     while (active_drones_count > 0 && current_time_step < MAX_TIME_STEPS && shared_mem->simulation_running) {
         pthread_mutex_lock(&data_mutex);
         log_time_step_header_to_report(current_time_step);
-        printf("\n--- Time Step %d ---\n", current_time_step);
+        if (!sim_options.display.diff_renderer) printf("\n--- Time Step %d ---\n", current_time_step);
 
+        int drones_finished_this_step = 0;
+        int drones_deactivated_this_step = 0;
         for (int i = 0; i < num_sim_drones; ++i) {
-            if (shared_mem->drones[i].active) {
-                sem_post(sim_drones[i].sem_child_can_act);
+            posted_this_step[i] = 0;
+            if (!shared_mem->drones[i].active) continue;
+
+            // A laggard skipped earlier only gets a new step once its late response is in.
+            if (drone_ack_outstanding[i]) {
+                if (sem_trywait(sim_drones[i].sem_parent_can_read) != 0) {
+                    latency_monitor_note_skipped_step(i); // Logged once when the response arrives or the run ends
+                    continue;
+                }
+                drone_ack_outstanding[i] = 0;
+                log_late_response_to_report(shared_mem->drones[i].id, drone_ack_missed_step[i], current_time_step);
+                if (process_drone_ack(i)) {
+                    drones_finished_this_step++;
+                    continue;
+                }
             }
+            drone_step_posted_ns[i] = latency_now_ns();
+            posted_this_step[i] = 1;
+            sem_post(sim_drones[i].sem_child_can_act);
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += sim_options.step_deadline_ms / 1000;
+        deadline.tv_nsec += (long)(sim_options.step_deadline_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
         }
 
-        int drones_finished_this_step = 0;
         for (int i = 0; i < num_sim_drones; ++i) {
-            if (shared_mem->drones[i].active) {
-                sem_wait(sim_drones[i].sem_parent_can_read);
-                if (shared_mem->drones[i].finished) {
-                    shared_mem->drones[i].active = 0;
-                    drones_finished_this_step++;
-                    log_drone_finish_to_report(&shared_mem->drones[i]);
-                } else {
-                    log_drone_update_to_report(&shared_mem->drones[i], sim_drones[i].instructions[shared_mem->drones[i].instruction_executed_index]);
+            if (!posted_this_step[i]) continue;
+
+            if (!wait_for_drone_ack(i, &deadline)) {
+                latency_monitor_note_deadline_miss(i);
+                switch (sim_options.laggard_policy) {
+                    case LAGGARD_WAIT:
+                        log_deadline_miss_to_report(shared_mem->drones[i].id, current_time_step, "waiting");
+                        while (sem_wait(sim_drones[i].sem_parent_can_read) == -1 && errno == EINTR) {}
+                        break;
+                    case LAGGARD_SKIP:
+                        log_deadline_miss_to_report(shared_mem->drones[i].id, current_time_step, "skipping drone until it responds");
+                        drone_ack_outstanding[i] = 1;
+                        drone_ack_missed_step[i] = current_time_step;
+                        continue;
+                    case LAGGARD_DEACTIVATE:
+                        log_deadline_miss_to_report(shared_mem->drones[i].id, current_time_step, "drone marked INACTIVE");
+                        drone_ack_outstanding[i] = 1;
+                        drone_ack_missed_step[i] = current_time_step;
+                        shared_mem->drones[i].active = 0;
+                        shared_mem->drones[i].terminate_flag = 1;
+                        latency_monitor_note_deactivated(i);
+                        latency_monitor_record_censored(i, latency_now_ns() - drone_step_posted_ns[i]);
+                        drones_deactivated_this_step++;
+                        if (overall_simulation_status_code < 2) overall_simulation_status_code = 3;
+                        continue;
                 }
             }
+            if (process_drone_ack(i)) drones_finished_this_step++;
+        }
+        active_drones_count -= drones_finished_this_step + drones_deactivated_this_step;
+
+        if (!position_history.disabled &&
+            !position_history_record(&position_history, current_time_step, shared_mem->drones)) {
+            if (position_history.disabled) {
+                log_error_to_report("Position history could not be extended; analytics will stop at this step.");
+            } else {
+                log_to_report("  Position history: Time Step %d already recorded; positions not stored again.\n",
+                              current_time_step);
+            }
         }
-        active_drones_count -= drones_finished_this_step;
 
-        display_drone_grid(current_time_step);
-        display_drone_summary_list(current_time_step);
+        int frame_captured = 0;
+        if (sim_options.display.diff_renderer) {
+            frame_captured = capture_drone_frame(current_time_step, 0);
+        } else {
+            display_drone_grid(current_time_step);
+            display_drone_summary_list(current_time_step);
+        }
 
         step_ready_for_collision_check = 1;
         pthread_cond_signal(&step_cond);
         pthread_mutex_unlock(&data_mutex);
+        if (frame_captured) draw_captured_frame(); // Terminal writes and key reads stay outside the lock
         usleep(10000);
     }
     
     pthread_mutex_lock(&data_mutex);
+    // A skipped laggard that never answered did not complete its plan: fail the run as for deactivation.
+    for (int i = 0; i < num_sim_drones; ++i) {
+        if (drone_ack_outstanding[i] && shared_mem->drones[i].active) {
+            log_late_response_to_report(shared_mem->drones[i].id, drone_ack_missed_step[i], -1);
+            latency_monitor_record_censored(i, latency_now_ns() - drone_step_posted_ns[i]);
+            if (overall_simulation_status_code < 2) overall_simulation_status_code = 3;
+        }
+    }
+    if (sim_options.display.diff_renderer) {
+        capture_drone_frame(current_time_step - 1, 1); // Frames may have been dropped by the rate cap
+    }
     shared_mem->simulation_running = 0;
+    simulation_loop_finished = 1;
     pthread_cond_broadcast(&step_cond);
     pthread_cond_broadcast(&collision_cond);
     pthread_mutex_unlock(&data_mutex);
 
+    if (sim_options.display.diff_renderer) {
+        draw_captured_frame();
+        close_diff_renderer();
+    }
+
     return NULL;
 }
 
@@ -107,30 +230,57 @@ void* collision_detection_thread(void* arg) {
         }
 
         int collisions_this_step_count = 0;
+        int records_this_step_count = 0;
+        // Separation only compares drones still flying or that landed this step, not parked ones.
+        int position_live[MAX_DRONES];
+        for (int i = 0; i < num_sim_drones; ++i) {
+            position_live[i] = shared_mem->drones[i].active || drone_last_ack_step[i] == current_time_step;
+        }
         for (int i = 0; i < num_sim_drones; ++i) {
             for (int j = i + 1; j < num_sim_drones; ++j) {
+                if (position_live[i] && position_live[j]) {
+                    long long dx = shared_mem->drones[i].x - shared_mem->drones[j].x;
+                    long long dy = shared_mem->drones[i].y - shared_mem->drones[j].y;
+                    long long dz = shared_mem->drones[i].z - shared_mem->drones[j].z;
+                    drone_stats_record_separation(i, j, dx * dx + dy * dy + dz * dz);
+                }
+
                  if (shared_mem->drones[i].x == shared_mem->drones[j].x &&
                     shared_mem->drones[i].y == shared_mem->drones[j].y &&
                     shared_mem->drones[i].z == shared_mem->drones[j].z) {
                     
                     collisions_this_step_count++;
-                    shared_mem->total_collisions_count++;
-                    total_collisions_count = shared_mem->total_collisions_count;
                     if (overall_simulation_status_code == 0) overall_simulation_status_code = 1;
-                    
-                    last_collision_info = (CollisionInfo){
-                        shared_mem->drones[i].id, shared_mem->drones[j].id,
-                        shared_mem->drones[i].x, shared_mem->drones[i].y, shared_mem->drones[i].z,
-                        current_time_step
-                    };
+
+                    // Per-step mode counts every colliding step; episode mode counts each contact once.
+                    int counts_as_new = 1;
+                    if (sim_options.per_step_collisions) {
+                        contact_tracker_record_step(shared_mem->drones[i].id, shared_mem->drones[j].id,
+                                                    shared_mem->drones[i].x, shared_mem->drones[i].y, shared_mem->drones[i].z,
+                                                    current_time_step);
+                    } else {
+                        counts_as_new = contact_tracker_observe(shared_mem->drones[i].id, shared_mem->drones[j].id,
+                                                                shared_mem->drones[i].x, shared_mem->drones[i].y, shared_mem->drones[i].z,
+                                                                current_time_step);
+                    }
+                    if (counts_as_new) {
+                        drone_stats_record_collision(i);
+                        drone_stats_record_collision(j);
+                        shared_mem->total_collisions_count++;
+                        total_collisions_count = shared_mem->total_collisions_count;
+                        records_this_step_count++;
+                    }
                     
                     kill(shared_mem->drones[i].pid, SIGUSR1);
                     kill(shared_mem->drones[j].pid, SIGUSR1);
                 }
             }
         }
+        if (!sim_options.per_step_collisions) {
+            records_this_step_count += contact_tracker_end_step(current_time_step);
+        }
 
-        if (collisions_this_step_count > 0) {
+        if (records_this_step_count > 0) {
             collision_event_occurred = 1;
             pthread_cond_signal(&collision_cond);
         }
@@ -147,6 +297,28 @@ void* collision_detection_thread(void* arg) {
     return NULL;
 }
 
+// Writes every pending collision record to the report. Caller holds data_mutex.
+static void drain_contact_records(void) {
+    ContactRecord record;
+    while (contact_tracker_pop(&record)) {
+        switch (record.type) {
+            case CONTACT_STEP:
+                log_collision_to_report(record.drone_id1, record.drone_id2,
+                                        record.x, record.y, record.z, record.start_step);
+                break;
+            case CONTACT_EPISODE_START:
+                log_contact_episode_start_to_report(record.drone_id1, record.drone_id2,
+                                                    record.x, record.y, record.z, record.start_step);
+                break;
+            case CONTACT_EPISODE_END:
+                log_contact_episode_end_to_report(record.drone_id1, record.drone_id2,
+                                                  record.x, record.y, record.z,
+                                                  record.start_step, record.end_step, record.cell_changes);
+                break;
+        }
+    }
+}
+
 void* report_generation_thread(void* arg) {
     while (shared_mem->simulation_running) {
         pthread_mutex_lock(&data_mutex);
@@ -156,29 +328,155 @@ void* report_generation_thread(void* arg) {
 
         if (collision_event_occurred) {
             log_to_report("Collision checks for this step:\n");
-            log_collision_to_report(last_collision_info.drone_id1, last_collision_info.drone_id2, 
-                                    last_collision_info.x, last_collision_info.y, last_collision_info.z, 
-                                    last_collision_info.time_step);
+            drain_contact_records();
             printf("  REPORT_THREAD: Notified of collision. Details logged.\n");
             collision_event_occurred = 0;
         }
         
         pthread_mutex_unlock(&data_mutex);
     }
+
+    // The run may have been stopped by the collision thread while the simulation thread is
+    // still doing its end-of-run logging and latency bookkeeping: wait for it to finish.
+    pthread_mutex_lock(&data_mutex);
+    while (!simulation_loop_finished) {
+        pthread_cond_wait(&collision_cond, &data_mutex);
+    }
+
+    // Close contact episodes still open when the simulation stopped.
+    if (contact_tracker_flush() > 0) log_to_report("Contacts still open at end of simulation:\n");
+    drain_contact_records();
     
     // MOVED: The final report generation is now done by this thread after the simulation loop ends.
     // This directly addresses the feedback on "Aggregation in report thread".
     log_simulation_summary_to_report(current_time_step - 1, overall_simulation_status_code);
+    if (drone_stats_write_csv(STATS_CSV_FILENAME)) {
+        log_to_report("\nPer-drone statistics written to %s.\n", STATS_CSV_FILENAME);
+    }
     close_report();
+    pthread_mutex_unlock(&data_mutex);
 
     return NULL;
 }
 
+// Parses the command line (see usage in main). Returns 1 on success, 0 on a bad option.
+static int parse_simulation_options(int argc, char *argv[], SimulationOptions* opts) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--per-step-collisions") == 0) {
+            opts->per_step_collisions = 1;
+        } else if (strncmp(argv[i], "--step-deadline-ms=", 19) == 0) {
+            opts->step_deadline_ms = atoi(argv[i] + 19);
+            if (opts->step_deadline_ms < 0) {
+                fprintf(stderr, "MAIN_CONTROLLER: Invalid step deadline '%s'\n", argv[i] + 19);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--laggard-policy=", 17) == 0) {
+            const char* policy = argv[i] + 17;
+            if (strcmp(policy, "wait") == 0) opts->laggard_policy = LAGGARD_WAIT;
+            else if (strcmp(policy, "skip") == 0) opts->laggard_policy = LAGGARD_SKIP;
+            else if (strcmp(policy, "deactivate") == 0) opts->laggard_policy = LAGGARD_DEACTIVATE;
+            else {
+                fprintf(stderr, "MAIN_CONTROLLER: Unknown laggard policy '%s'\n", policy);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--shm-hugepages") == 0) {
+            opts->shm.huge_pages = 1;
+        } else if (strcmp(argv[i], "--shm-prefault") == 0) {
+            opts->shm.prefault = 1;
+        } else if (strcmp(argv[i], "--shm-numa") == 0) {
+            opts->shm.numa_bind = 1;
+        } else if (strcmp(argv[i], "--render=diff") == 0) {
+            opts->display.diff_renderer = 1;
+        } else if (strcmp(argv[i], "--render=grid") == 0) {
+            opts->display.diff_renderer = 0;
+        } else if (strncmp(argv[i], "--viewport=", 11) == 0) {
+            DisplayOptions* d = &opts->display;
+            if (sscanf(argv[i] + 11, "%d,%d,%d,%d", &d->view_x, &d->view_y, &d->view_width, &d->view_height) != 4 ||
+                d->view_width <= 0 || d->view_height <= 0) {
+                fprintf(stderr, "MAIN_CONTROLLER: Invalid viewport '%s' (expected X,Y,W,H)\n", argv[i] + 11);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--zoom=", 7) == 0) {
+            opts->display.zoom = atoi(argv[i] + 7);
+            if (opts->display.zoom < 1) {
+                fprintf(stderr, "MAIN_CONTROLLER: Invalid zoom '%s'\n", argv[i] + 7);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--z-slice=", 10) == 0) {
+            DisplayOptions* d = &opts->display;
+            if (sscanf(argv[i] + 10, "%d:%d", &d->z_min, &d->z_max) != 2 || d->z_max < d->z_min) {
+                fprintf(stderr, "MAIN_CONTROLLER: Invalid altitude slice '%s' (expected LO:HI)\n", argv[i] + 10);
+                return 0;
+            }
+            d->z_slice = 1;
+        } else if (strncmp(argv[i], "--max-fps=", 10) == 0) {
+            opts->display.max_fps = atoi(argv[i] + 10);
+            if (opts->display.max_fps < 0) {
+                fprintf(stderr, "MAIN_CONTROLLER: Invalid frame rate '%s'\n", argv[i] + 10);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--first-conflict") == 0) {
+            opts->first_conflict = FIRST_CONFLICT_ANY;
+        } else if (strcmp(argv[i], "--first-conflict=threshold") == 0) {
+            opts->first_conflict = FIRST_CONFLICT_THRESHOLD;
+        } else if (strncmp(argv[i], "--plan-list=", 12) == 0) {
+            opts->plan_list_filename = argv[i] + 12;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "MAIN_CONTROLLER: Unknown option '%s'\n", argv[i]);
+            return 0;
+        } else {
+            opts->csv_filename = argv[i];
+        }
+    }
+    return 1;
+}
+
+// --first-conflict: validates every plan file named on the command line, then those in the
+// --plan-list file (the default plan if neither is given), without forking drones or writing
+// the report. Exit code as in ValidationResult: the worst over all plans.
+static int run_first_conflict_validation(int argc, char *argv[]) {
+    const char** plan_files = malloc(sizeof(const char*) * (size_t)argc);
+    if (!plan_files) return VALIDATION_ERROR;
+    int plan_count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--", 2) != 0) plan_files[plan_count++] = argv[i];
+    }
+    if (plan_count == 0 && !sim_options.plan_list_filename) plan_files[plan_count++] = sim_options.csv_filename;
+
+    int worst = validate_plan_files(plan_files, plan_count, sim_options.first_conflict,
+                                    sim_options.per_step_collisions);
+    free(plan_files);
+    if (sim_options.plan_list_filename) {
+        int list_worst = validate_plan_list(sim_options.plan_list_filename, sim_options.first_conflict,
+                                            sim_options.per_step_collisions);
+        if (list_worst > worst) worst = list_worst;
+    }
+    return worst;
+}
+
 int main(int argc, char *argv[]) {
-    atexit(cleanup_simulation_resources);
+    if (!parse_simulation_options(argc, argv, &sim_options)) {
+        fprintf(stderr, "Usage: %s [--per-step-collisions] [--step-deadline-ms=N] "
+                        "[--laggard-policy=wait|skip|deactivate] [--shm-hugepages] [--shm-prefault] "
+                        "[--shm-numa] [--render=diff|grid] [--viewport=X,Y,W,H] [--zoom=N] "
+                        "[--z-slice=LO:HI] [--max-fps=N] [flight_plan.csv]\n"
+                        "       %s --first-conflict[=threshold] [--per-step-collisions] "
+                        "[--plan-list=FILE|-] [flight_plan.csv ...]\n", argv[0], argv[0]);
+        // Parsing may stop before --first-conflict is seen, so scan argv: a validation gate must
+        // read a bad option as an error, not as VALIDATION_CONFLICT (== EXIT_FAILURE).
+        for (int i = 1; i < argc; ++i) {
+            if (strncmp(argv[i], "--first-conflict", 16) == 0) return VALIDATION_ERROR;
+        }
+        return EXIT_FAILURE;
+    }
+    if (sim_options.first_conflict != FIRST_CONFLICT_OFF) {
+        return run_first_conflict_validation(argc, argv);
+    }
 
-    const char* csv_filename = "drones_flight_plan.csv";
-    if (argc > 1) csv_filename = argv[1];
+    atexit(cleanup_simulation_resources);
+    const char* csv_filename = sim_options.csv_filename;
+    contact_tracker_reset();
+    latency_monitor_reset();
 
     init_display();
     if (!init_report(REPORT_FILENAME)) return EXIT_FAILURE;
@@ -192,10 +490,35 @@ int main(int argc, char *argv[]) {
         return num_sim_drones == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    int shm_fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
-    ftruncate(shm_fd, sizeof(SharedMemoryLayout));
-    shared_mem = mmap(0, sizeof(SharedMemoryLayout), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    close(shm_fd);
+    if (!shm_segment_create(&shm_segment, SHM_NAME, sizeof(SharedMemoryLayout), &sim_options.shm)) {
+        log_error_to_report("Could not create the shared memory segment.");
+        close_report();
+        return EXIT_FAILURE;
+    }
+    if (sim_options.shm.numa_bind) {
+        // Each child writes only its own DroneSharedState: place those pages on the child's node.
+        // That only works if no page holds slots of drones assigned to different nodes; otherwise
+        // binding and pinning would make some writers remote, so neither is done.
+        size_t slots_offset = offsetof(SharedMemoryLayout, drones);
+        if (shm_segment_numa_node_count() <= 1) {
+            log_to_report("MAIN_CONTROLLER: --shm-numa had no effect: only one NUMA node.\n");
+            sim_options.shm.numa_bind = 0;
+        } else if (!shm_segment_partitions_separable(&shm_segment, slots_offset, sizeof(DroneSharedState), num_sim_drones)) {
+            log_to_report("MAIN_CONTROLLER: --shm-numa had no effect: %zu-byte drone slots share %zu-byte pages "
+                          "across NUMA nodes; pages left unbound and drones not pinned.\n",
+                          sizeof(DroneSharedState), shm_segment.page_size);
+            sim_options.shm.numa_bind = 0;
+        } else {
+            shm_segment_bind_partitions(&shm_segment, slots_offset, sizeof(DroneSharedState), num_sim_drones);
+        }
+        // Creation deferred pre-faulting until after binding.
+        if (sim_options.shm.prefault) shm_segment_prefault(&shm_segment);
+    }
+    shared_mem = shm_segment.addr;
+    log_to_report("MAIN_CONTROLLER: Shared memory segment: %zu bytes, %s%s%s.\n",
+                  shm_segment.size, shm_segment_backing_name(&shm_segment),
+                  sim_options.shm.prefault ? ", pre-faulted" : "",
+                  sim_options.shm.numa_bind ? ", NUMA-bound" : "");
 
     shared_mem->simulation_running = 1;
     shared_mem->total_collisions_count = 0;
@@ -211,6 +534,14 @@ int main(int argc, char *argv[]) {
         shared_mem->drones[i] = (DroneSharedState){.id = sim_drones[i].id, .x = sim_drones[i].initial_x, .y = sim_drones[i].initial_y, .z = sim_drones[i].initial_z, .active = 1, .finished = 0, .terminate_flag = 0};
     }
 
+    drone_stats_reset(shared_mem->drones, num_sim_drones);
+
+    // Step 0 of the position history is the initial layout.
+    if (!position_history_init(&position_history, num_sim_drones) ||
+        !position_history_record(&position_history, 0, shared_mem->drones)) {
+        log_error_to_report("Position history unavailable; post-run analytics disabled.");
+    }
+
     log_initial_drone_states_to_report();
     printf("MAIN_CONTROLLER: Loaded %d drones. Starting simulation...\n", num_sim_drones);
 
@@ -225,6 +556,11 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // After fork(): children must not inherit the renderer's atexit terminal restore.
+    if (sim_options.display.diff_renderer && !init_diff_renderer(&sim_options.display)) {
+        sim_options.display.diff_renderer = 0; // Fall back to the full-grid display
+    }
+
     pthread_create(&sim_thread_id, NULL, simulation_loop_thread, NULL);
     pthread_create(&collision_thread_id, NULL, collision_detection_thread, NULL);
     pthread_create(&report_thread_id, NULL, report_generation_thread, NULL);
@@ -237,6 +573,8 @@ int main(int argc, char *argv[]) {
     for (int i = 0; i < num_sim_drones; ++i) {
         shared_mem->drones[i].terminate_flag = 1;
         sem_post(sim_drones[i].sem_child_can_act); // Unblock any waiting child
+        // A drone that never answered its last step may be stalled: don't let waitpid hang on it.
+        if (drone_ack_outstanding[i] && sim_drones[i].pid > 0) kill(sim_drones[i].pid, SIGKILL);
     }
 
     printf("\nMAIN_CONTROLLER: Simulation ended. Waiting for child processes...\n");
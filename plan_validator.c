@@ -0,0 +1,137 @@
+// plan_validator.c
+#include "plan_validator.h"
+#include "step_kernel.h"
+#include "latency_monitor.h" // For latency_now_ns
+
+// Scratch space for one plan at a time; validation never touches the simulation globals.
+static Drone plan_drones[MAX_DRONES];
+
+// Upper bound on the cells drone i can still move after `steps_done` steps.
+static int remaining_moves(const StepKernelBatch* batch, int i, int steps_done) {
+    if (!batch->active[i]) return 0;
+    int last_step = batch->num_instructions[i] < MAX_TIME_STEPS - 1 ? batch->num_instructions[i] : MAX_TIME_STEPS - 1;
+    return last_step > steps_done ? last_step - steps_done : 0;
+}
+
+ValidationResult validate_flight_plans(const Drone drones_arr[], int drone_count, FirstConflictMode mode,
+                                       int per_step_collisions, ValidationOutcome* out) {
+    memset(out, 0, sizeof(*out));
+    out->result = VALIDATION_CLEAR;
+    if (drone_count <= 0) return out->result;
+
+    StepKernelBatch batch;
+    if (!step_kernel_load_drones(&batch, drones_arr, drone_count)) {
+        out->result = VALIDATION_ERROR;
+        return out->result;
+    }
+
+    // Episode mode: pairs that shared a cell in the previous step do not count again.
+    uint8_t in_contact[MAX_DRONES][MAX_DRONES] = {{0}};
+    int still_active = drone_count;
+    // Same loop bounds as simulation_loop_thread: steps 1 .. MAX_TIME_STEPS - 1 while any drone is active.
+    for (int step = 1; step < MAX_TIME_STEPS && still_active > 0; ++step) {
+        still_active = step_kernel_advance(&batch);
+        out->step = step;
+
+        int any_pair_can_meet = 0;
+        for (int i = 0; i < drone_count; ++i) {
+            for (int j = i + 1; j < drone_count; ++j) {
+                int distance = abs(batch.x[i] - batch.x[j]) + abs(batch.y[i] - batch.y[j]) + abs(batch.z[i] - batch.z[j]);
+                if (distance != 0) {
+                    in_contact[i][j] = 0;
+                    if (distance <= remaining_moves(&batch, i, step) + remaining_moves(&batch, j, step)) {
+                        any_pair_can_meet = 1;
+                    }
+                    continue;
+                }
+
+                any_pair_can_meet = 1;
+                int counts_as_new = per_step_collisions || !in_contact[i][j];
+                in_contact[i][j] = 1;
+                if (!counts_as_new) continue;
+                out->collisions++;
+                if (mode == FIRST_CONFLICT_ANY || out->collisions >= COLLISION_THRESHOLD) {
+                    out->result = VALIDATION_CONFLICT;
+                    out->drone_id1 = batch.ids[i];
+                    out->drone_id2 = batch.ids[j];
+                    out->x = batch.x[i];
+                    out->y = batch.y[i];
+                    out->z = batch.z[i];
+                    step_kernel_free(&batch);
+                    return out->result;
+                }
+            }
+        }
+
+        if (!any_pair_can_meet && still_active > 0) {
+            out->proven_early = 1; // Remaining moves cannot close any gap: no later collision
+            break;
+        }
+    }
+
+    step_kernel_free(&batch);
+    return out->result;
+}
+
+// Validates one plan file and prints its result line.
+static ValidationResult validate_plan_file(const char* filename, FirstConflictMode mode, int per_step_collisions) {
+    long long start_ns = latency_now_ns();
+    int drone_count = 0;
+    ValidationOutcome outcome;
+    if (!load_drones_from_csv(filename, plan_drones, &drone_count)) {
+        printf("%s: ERROR could not load flight plan\n", filename);
+        return VALIDATION_ERROR;
+    }
+    validate_flight_plans(plan_drones, drone_count, mode, per_step_collisions, &outcome);
+    double elapsed_us = (latency_now_ns() - start_ns) / 1e3;
+
+    switch (outcome.result) {
+        case VALIDATION_CONFLICT:
+            printf("%s: CONFLICT step=%d drones=%d,%d pos=(%d,%d,%d) collisions=%d time_us=%.1f\n",
+                   filename, outcome.step, outcome.drone_id1, outcome.drone_id2,
+                   outcome.x, outcome.y, outcome.z, outcome.collisions, elapsed_us);
+            break;
+        case VALIDATION_CLEAR:
+            printf("%s: CLEAR steps=%d%s collisions=%d time_us=%.1f\n",
+                   filename, outcome.step, outcome.proven_early ? " (proven early)" : "",
+                   outcome.collisions, elapsed_us);
+            break;
+        default:
+            printf("%s: ERROR could not prepare trajectories\n", filename);
+            break;
+    }
+    return outcome.result;
+}
+
+int validate_plan_files(const char* const filenames[], int file_count, FirstConflictMode mode,
+                        int per_step_collisions) {
+    int worst = VALIDATION_CLEAR;
+    for (int i = 0; i < file_count; ++i) {
+        ValidationResult result = validate_plan_file(filenames[i], mode, per_step_collisions);
+        if ((int)result > worst) worst = result;
+    }
+    fflush(stdout);
+    return worst;
+}
+
+int validate_plan_list(const char* list_filename, FirstConflictMode mode, int per_step_collisions) {
+    int from_stdin = strcmp(list_filename, "-") == 0;
+    FILE* list = from_stdin ? stdin : fopen(list_filename, "r");
+    if (!list) {
+        perror("PLAN_VALIDATOR: Error opening plan list");
+        return VALIDATION_ERROR;
+    }
+
+    int worst = VALIDATION_CLEAR;
+    char line[BUFFER_SIZE];
+    while (fgets(line, sizeof(line), list)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;
+        ValidationResult result = validate_plan_file(line, mode, per_step_collisions);
+        if ((int)result > worst) worst = result;
+    }
+
+    if (!from_stdin) fclose(list);
+    fflush(stdout);
+    return worst;
+}
@@ -0,0 +1,39 @@
+// plan_validator.h
+#ifndef PLAN_VALIDATOR_H
+#define PLAN_VALIDATOR_H
+
+#include "drone_simulation.h" // For Drone, FirstConflictMode and COLLISION_THRESHOLD
+
+// Exit codes of the --first-conflict mode. A batch exits with the highest code of its plans.
+typedef enum {
+    VALIDATION_CLEAR = 0,     // No conflict within MAX_TIME_STEPS
+    VALIDATION_CONFLICT = 1,  // The stop condition was reached
+    VALIDATION_ERROR = 2      // The plan could not be loaded
+} ValidationResult;
+
+typedef struct {
+    ValidationResult result;
+    int step;                   // Step of the deciding collision, or the last step simulated
+    int drone_id1, drone_id2;   // Pair of the deciding collision (CONFLICT only)
+    int x, y, z;                // Cell of the deciding collision (CONFLICT only)
+    int collisions;             // Collisions counted up to `step` (episodes or steps, as configured)
+    int proven_early;           // 1 if CLEAR was proven before all plans ran out
+} ValidationOutcome;
+
+// Replays the flight plans in-process with the step kernel, one step at a time, using the
+// same step numbering and collision rules as the full simulation. Stops at the first
+// step that decides the outcome: the stop condition is met, or no pair can still meet
+// because every pair is further apart than its combined remaining moves.
+// Returns the result (also stored in `out`).
+ValidationResult validate_flight_plans(const Drone drones_arr[], int drone_count, FirstConflictMode mode,
+                                       int per_step_collisions, ValidationOutcome* out);
+
+// Loads and validates each plan file, printing one line per file to stdout.
+// Returns the highest ValidationResult over all files.
+int validate_plan_files(const char* const filenames[], int file_count, FirstConflictMode mode,
+                        int per_step_collisions);
+
+// Reads plan file names (one per line, "-" for stdin) and validates them like validate_plan_files.
+int validate_plan_list(const char* list_filename, FirstConflictMode mode, int per_step_collisions);
+
+#endif // PLAN_VALIDATOR_H
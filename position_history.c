@@ -0,0 +1,224 @@
+// position_history.c
+#include "position_history.h"
+
+// Move codes: one unit along one axis, or no move. Anything else forces a keyframe.
+enum { MOVE_STAY, MOVE_POS_X, MOVE_NEG_X, MOVE_POS_Y, MOVE_NEG_Y, MOVE_POS_Z, MOVE_NEG_Z };
+static const int8_t move_dx[8] = { [MOVE_POS_X] = 1, [MOVE_NEG_X] = -1 };
+static const int8_t move_dy[8] = { [MOVE_POS_Y] = 1, [MOVE_NEG_Y] = -1 };
+static const int8_t move_dz[8] = { [MOVE_POS_Z] = 1, [MOVE_NEG_Z] = -1 };
+
+// Returns the move code for a delta, or -1 if it does not fit in one code.
+static int encode_move(int dx, int dy, int dz) {
+    if (dx == 0 && dy == 0 && dz == 0) return MOVE_STAY;
+    if (dy == 0 && dz == 0) return dx == 1 ? MOVE_POS_X : dx == -1 ? MOVE_NEG_X : -1;
+    if (dx == 0 && dz == 0) return dy == 1 ? MOVE_POS_Y : dy == -1 ? MOVE_NEG_Y : -1;
+    if (dx == 0 && dy == 0) return dz == 1 ? MOVE_POS_Z : dz == -1 ? MOVE_NEG_Z : -1;
+    return -1;
+}
+
+static const uint8_t* step_row(const PositionHistory* history, int step) {
+    return history->deltas + (size_t)step * history->bytes_per_step;
+}
+
+static int read_code(const uint8_t* row, int drone_index) {
+    int bit = drone_index * HISTORY_CODE_BITS;
+    unsigned pair = row[bit >> 3] | ((unsigned)row[(bit >> 3) + 1] << 8);
+    return (pair >> (bit & 7)) & 7;
+}
+
+static void write_code(uint8_t* row, int drone_index, int code) {
+    int bit = drone_index * HISTORY_CODE_BITS;
+    unsigned shifted = (unsigned)code << (bit & 7);
+    row[bit >> 3] |= (uint8_t)shifted;
+    row[(bit >> 3) + 1] |= (uint8_t)(shifted >> 8);
+}
+
+static int grow_array(void** ptr, int* capacity, int needed, size_t elem_size) {
+    if (needed <= *capacity) return 1;
+    int new_capacity = *capacity > 0 ? *capacity : 16;
+    while (new_capacity < needed) new_capacity *= 2;
+    void* grown = realloc(*ptr, (size_t)new_capacity * elem_size);
+    if (!grown) {
+        perror("POSITION_HISTORY: Error growing history");
+        return 0;
+    }
+    *ptr = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+typedef struct { int32_t x; int index; } KeyedIndex;
+
+static int compare_keyed_index(const void* a, const void* b) {
+    const KeyedIndex* ka = a;
+    const KeyedIndex* kb = b;
+    if (ka->x != kb->x) return (ka->x > kb->x) - (ka->x < kb->x);
+    return ka->index - kb->index;
+}
+
+// Stores last_positions as a keyframe at `step`, with its x-sorted index.
+static int add_keyframe(PositionHistory* history, int step) {
+    int n = history->num_drones;
+    int k = history->num_keyframes;
+    int steps_capacity = history->keyframe_capacity;
+    int positions_capacity = history->keyframe_capacity;
+    int order_capacity = history->keyframe_capacity;
+
+    if (!grow_array((void**)&history->keyframe_steps, &steps_capacity, k + 1, sizeof(int)) ||
+        !grow_array((void**)&history->keyframe_positions, &positions_capacity, k + 1, (size_t)n * 3 * sizeof(int32_t)) ||
+        !grow_array((void**)&history->keyframe_order_by_x, &order_capacity, k + 1, (size_t)n * sizeof(int))) {
+        return 0;
+    }
+    history->keyframe_capacity = steps_capacity;
+
+    history->keyframe_steps[k] = step;
+    memcpy(history->keyframe_positions + (size_t)k * n * 3, history->last_positions, (size_t)n * 3 * sizeof(int32_t));
+
+    KeyedIndex* keyed = malloc((size_t)(n > 0 ? n : 1) * sizeof(KeyedIndex));
+    if (!keyed) {
+        perror("POSITION_HISTORY: Error sorting keyframe");
+        return 0;
+    }
+    for (int i = 0; i < n; ++i) keyed[i] = (KeyedIndex){ history->last_positions[i * 3], i };
+    qsort(keyed, (size_t)n, sizeof(KeyedIndex), compare_keyed_index);
+    int* order = history->keyframe_order_by_x + (size_t)k * n;
+    for (int i = 0; i < n; ++i) order[i] = keyed[i].index;
+    free(keyed);
+
+    history->num_keyframes++;
+    return 1;
+}
+
+// Index of the last keyframe at or before `step` (binary search).
+static int keyframe_for_step(const PositionHistory* history, int step) {
+    int lo = 0, hi = history->num_keyframes - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (history->keyframe_steps[mid] <= step) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+// Replays drone i's moves from keyframe `k` up to `step`.
+static void replay(const PositionHistory* history, int k, int drone_index, int step, int* x, int* y, int* z) {
+    const int32_t* base = history->keyframe_positions + ((size_t)k * history->num_drones + drone_index) * 3;
+    int px = base[0], py = base[1], pz = base[2];
+    for (int s = history->keyframe_steps[k] + 1; s <= step; ++s) {
+        int code = read_code(step_row(history, s), drone_index);
+        px += move_dx[code];
+        py += move_dy[code];
+        pz += move_dz[code];
+    }
+    *x = px; *y = py; *z = pz;
+}
+
+int position_history_init(PositionHistory* history, int num_drones) {
+    memset(history, 0, sizeof(*history));
+    history->disabled = 1;
+    if (num_drones < 0) return 0;
+    history->last_positions = calloc((size_t)(num_drones > 0 ? num_drones : 1) * 3, sizeof(int32_t));
+    if (!history->last_positions) {
+        perror("POSITION_HISTORY: Error allocating history");
+        return 0;
+    }
+    history->num_drones = num_drones;
+    history->bytes_per_step = (num_drones * HISTORY_CODE_BITS + 7) / 8 + 1;
+    history->disabled = 0;
+    return 1;
+}
+
+void position_history_free(PositionHistory* history) {
+    free(history->deltas);
+    free(history->keyframe_steps);
+    free(history->keyframe_positions);
+    free(history->keyframe_order_by_x);
+    free(history->last_positions);
+    memset(history, 0, sizeof(*history));
+}
+
+int position_history_record(PositionHistory* history, int step, const DroneSharedState drones[]) {
+    if (history->disabled || step < history->num_steps) return 0;
+    if (step > history->num_steps) {
+        history->disabled = 1; // A gap would shift every later step
+        return 0;
+    }
+    int n = history->num_drones;
+    if (!grow_array((void**)&history->deltas, &history->step_capacity, step + 1, (size_t)history->bytes_per_step)) {
+        history->disabled = 1;
+        return 0;
+    }
+    uint8_t* row = history->deltas + (size_t)step * history->bytes_per_step;
+    memset(row, 0, (size_t)history->bytes_per_step);
+
+    int needs_keyframe = (step == 0) ||
+        (step - history->keyframe_steps[history->num_keyframes - 1] >= HISTORY_KEYFRAME_INTERVAL);
+    for (int i = 0; i < n && !needs_keyframe; ++i) {
+        int code = encode_move(drones[i].x - history->last_positions[i * 3],
+                               drones[i].y - history->last_positions[i * 3 + 1],
+                               drones[i].z - history->last_positions[i * 3 + 2]);
+        if (code < 0) needs_keyframe = 1;
+        else write_code(row, i, code);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        history->last_positions[i * 3] = drones[i].x;
+        history->last_positions[i * 3 + 1] = drones[i].y;
+        history->last_positions[i * 3 + 2] = drones[i].z;
+    }
+    if (needs_keyframe) {
+        memset(row, 0, (size_t)history->bytes_per_step);
+        if (!add_keyframe(history, step)) {
+            history->disabled = 1; // last_positions already moved on: later deltas would be wrong
+            return 0;
+        }
+    }
+    history->num_steps++;
+    return 1;
+}
+
+int position_history_get(const PositionHistory* history, int drone_index, int step, int* x, int* y, int* z) {
+    if (step < 0 || step >= history->num_steps || drone_index < 0 || drone_index >= history->num_drones) return 0;
+    replay(history, keyframe_for_step(history, step), drone_index, step, x, y, z);
+    return 1;
+}
+
+int position_history_query_box(const PositionHistory* history, int step,
+                               int min_x, int max_x, int min_y, int max_y, int min_z, int max_z,
+                               int* out_indices, int max_out) {
+    if (step < 0 || step >= history->num_steps) return -1;
+    int n = history->num_drones;
+    int k = keyframe_for_step(history, step);
+    // Each step moves a drone at most one unit, so it is within `drift` of its keyframe position.
+    int drift = step - history->keyframe_steps[k];
+    const int32_t* positions = history->keyframe_positions + (size_t)k * n * 3;
+    const int* order = history->keyframe_order_by_x + (size_t)k * n;
+
+    // First drone (in x order) whose keyframe x could still reach min_x.
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (positions[order[mid] * 3] < min_x - drift) lo = mid + 1;
+        else hi = mid;
+    }
+
+    int found = 0;
+    for (int o = lo; o < n && positions[order[o] * 3] <= max_x + drift; ++o) {
+        int i = order[o];
+        const int32_t* p = positions + i * 3;
+        if (p[1] < min_y - drift || p[1] > max_y + drift || p[2] < min_z - drift || p[2] > max_z + drift) continue;
+
+        int x, y, z;
+        replay(history, k, i, step, &x, &y, &z);
+        if (x < min_x || x > max_x || y < min_y || y > max_y || z < min_z || z > max_z) continue;
+        if (found < max_out) out_indices[found] = i;
+        found++;
+    }
+    return found;
+}
+
+size_t position_history_memory_bytes(const PositionHistory* history) {
+    size_t n = (size_t)history->num_drones;
+    return (size_t)history->num_steps * history->bytes_per_step +
+           (size_t)history->num_keyframes * (sizeof(int) + n * 3 * sizeof(int32_t) + n * sizeof(int));
+}
@@ -0,0 +1,64 @@
+// position_history.h
+#ifndef POSITION_HISTORY_H
+#define POSITION_HISTORY_H
+
+#include <stdint.h>
+#include "drone_simulation.h" // For DroneSharedState
+
+// A full copy of all positions is stored at least every this many steps.
+// Position queries replay at most HISTORY_KEYFRAME_INTERVAL - 1 deltas.
+#define HISTORY_KEYFRAME_INTERVAL 16
+// Each drone's move in a step is one 3-bit code (see position_history.c).
+#define HISTORY_CODE_BITS 3
+
+// Compressed per-step position history of a fleet.
+// Step 0 is the initial state; step n is the state after n recorded steps.
+// Steps where some drone moved by more than one unit along one axis become
+// keyframes automatically, so deltas always fit in HISTORY_CODE_BITS.
+typedef struct {
+    int num_drones;
+    int num_steps;               // Steps recorded so far
+    int step_capacity;
+    int bytes_per_step;          // ceil(num_drones * HISTORY_CODE_BITS / 8), plus one spare byte
+    uint8_t *deltas;             // [step_capacity][bytes_per_step] packed move codes
+
+    int num_keyframes;
+    int keyframe_capacity;
+    int *keyframe_steps;         // Ascending step numbers of keyframes
+    int32_t *keyframe_positions; // [keyframe][drone][3]
+    int *keyframe_order_by_x;    // [keyframe][num_drones] drone indices sorted by x, for box queries
+
+    int32_t *last_positions;     // [drone][3] positions at the last recorded step
+    int disabled;                // 1 after an init/record failure or a missing step: nothing more is recorded
+} PositionHistory;
+
+// History filled by the simulation loop thread (defined in main_controller.c).
+extern PositionHistory position_history;
+
+// Prepares an empty history for `num_drones` drones. Returns 1 on success; on failure
+// returns 0 and leaves the history disabled.
+int position_history_init(PositionHistory* history, int num_drones);
+
+// Releases all memory owned by the history.
+void position_history_free(PositionHistory* history);
+
+// Records the positions of drones[0..num_drones-1] as `step`, which must be the next step
+// (num_steps). A step already recorded is rejected and the history is left unchanged; a
+// skipped step or an allocation failure disables the history, so recorded steps always
+// keep their simulation step numbers. Returns 1 if the step was recorded, 0 otherwise.
+int position_history_record(PositionHistory* history, int step, const DroneSharedState drones[]);
+
+// Position of drone `drone_index` at `step`. Returns 1 on success, 0 if out of range.
+int position_history_get(const PositionHistory* history, int drone_index, int step, int* x, int* y, int* z);
+
+// Indices of drones inside the inclusive box at `step`, written to `out_indices` (up to `max_out`).
+// Only drones whose keyframe position is within reach of the box are replayed.
+// Returns the number of drones found (may exceed `max_out`), or -1 if `step` is out of range.
+int position_history_query_box(const PositionHistory* history, int step,
+                               int min_x, int max_x, int min_y, int max_y, int min_z, int max_z,
+                               int* out_indices, int max_out);
+
+// Bytes occupied by the recorded steps and keyframes (for the report).
+size_t position_history_memory_bytes(const PositionHistory* history);
+
+#endif // POSITION_HISTORY_H
@@ -1,5 +1,9 @@
 // reporting.c
 #include "drone_simulation.h"
+#include "contact_tracker.h"
+#include "latency_monitor.h"
+#include "position_history.h"
+#include "drone_stats.h"
 #include <stdarg.h> // For va_list, va_start, va_end
 
 // Global definition for report_file (declared extern in .h)
@@ -7,7 +11,7 @@ FILE *report_file = NULL;
 // Global definitions for collision logging (declared extern in .h)
 CollisionEvent collision_log[MAX_DRONES * MAX_TIME_STEPS];
 int collision_log_index = 0;
-SharedMemoryLayout *shared_mem; // This is needed to access drone states
+extern SharedMemoryLayout *shared_mem; // Defined in main_controller.c; needed to access drone states
 
 
 
@@ -82,6 +86,23 @@ void log_error_to_report(const char* error_message) {
     fflush(report_file);
 }
 
+// Appends an entry to the internal collision log used by the summary (bounded).
+static void append_collision_log(int drone_id1, int drone_id2, int x, int y, int z,
+                                 int start_step, int end_step, int cell_changes, time_t when) {
+    if (collision_log_index < (MAX_DRONES * MAX_TIME_STEPS)) {
+        collision_log[collision_log_index].time_step = start_step;
+        collision_log[collision_log_index].timestamp = when;
+        collision_log[collision_log_index].drone_id1 = drone_id1;
+        collision_log[collision_log_index].drone_id2 = drone_id2;
+        collision_log[collision_log_index].x = x;
+        collision_log[collision_log_index].y = y;
+        collision_log[collision_log_index].z = z;
+        collision_log[collision_log_index].end_step = end_step;
+        collision_log[collision_log_index].cell_changes = cell_changes;
+        collision_log_index++;
+    }
+}
+
 // Logs a detected collision event.
 void log_collision_to_report(int drone_id1, int drone_id2, int x, int y, int z, int time_step) {
     if (!report_file) return;
@@ -94,19 +115,57 @@ void log_collision_to_report(int drone_id1, int drone_id2, int x, int y, int z,
     fflush(report_file);
 
     // Also add to the internal collision log for summary
-    if (collision_log_index < (MAX_DRONES * MAX_TIME_STEPS)) {
-        collision_log[collision_log_index].time_step = time_step;
-        collision_log[collision_log_index].timestamp = now;
-        collision_log[collision_log_index].drone_id1 = drone_id1;
-        collision_log[collision_log_index].drone_id2 = drone_id2;
-        collision_log[collision_log_index].x = x;
-        collision_log[collision_log_index].y = y;
-        collision_log[collision_log_index].z = z;
-        collision_log_index++;
-    }
+    append_collision_log(drone_id1, drone_id2, x, y, z, time_step, time_step, 1, now);
+}
+
+// Logs the start of a contact episode (two drones entering the same cell).
+void log_contact_episode_start_to_report(int drone_id1, int drone_id2, int x, int y, int z, int time_step) {
+    if (!report_file) return;
+    time_t now = time(NULL);
+    char time_str_buffer[30];
+    strftime(time_str_buffer, sizeof(time_str_buffer), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    fprintf(report_file, "  COLLISION START! Drones %d and %d at (%d, %d, %d), Time Step %d. Timestamp: %s\n",
+            drone_id1, drone_id2, x, y, z, time_step, time_str_buffer);
+    fflush(report_file);
+}
+
+// Logs the end of a contact episode. Only the completed episode goes to the collision log.
+void log_contact_episode_end_to_report(int drone_id1, int drone_id2, int x, int y, int z,
+                                       int start_step, int end_step, int cell_changes) {
+    if (!report_file) return;
+    time_t now = time(NULL);
+    int duration = end_step - start_step + 1;
+
+    fprintf(report_file, "  COLLISION END: Drones %d and %d in contact for %d step(s) (Time Steps %d-%d), "
+            "%d cell change(s), last at (%d, %d, %d).\n",
+            drone_id1, drone_id2, duration, start_step, end_step, cell_changes, x, y, z);
+    fflush(report_file);
+
+    append_collision_log(drone_id1, drone_id2, x, y, z, start_step, end_step, cell_changes, now);
 }
 
 
+// Logs that a drone did not acknowledge a step before the deadline, and what was done about it.
+void log_deadline_miss_to_report(int drone_id, int time_step, const char* action) {
+    if (!report_file) return;
+    fprintf(report_file, "  DEADLINE MISS: Drone ID %d did not respond within %d ms at Time Step %d (%s).\n",
+            drone_id, sim_options.step_deadline_ms, time_step, action);
+    fflush(report_file);
+}
+
+void log_late_response_to_report(int drone_id, int missed_step, int time_step) {
+    if (!report_file) return;
+    if (time_step >= 0) {
+        fprintf(report_file, "  LATE RESPONSE: Drone ID %d answered Time Step %d late; response collected at Time Step %d (%d step(s) skipped).\n",
+                drone_id, missed_step, time_step, time_step - missed_step - 1);
+    } else {
+        fprintf(report_file, "  NO RESPONSE: Drone ID %d never answered Time Step %d; still outstanding at end of simulation.\n",
+                drone_id, missed_step);
+    }
+    fflush(report_file);
+}
+
 // Logs the final summary of the simulation.
 void log_simulation_summary_to_report(int final_time_step, int simulation_status_code) {
     if (!report_file) return;
@@ -115,6 +174,8 @@ void log_simulation_summary_to_report(int final_time_step, int simulation_status
     fprintf(report_file, "Total Time Steps Executed: %d\n", final_time_step > 0 ? final_time_step : 0);
     fprintf(report_file, "Total Collisions Detected: %d\n", total_collisions_count);
 
+    fprintf(report_file, "Collision Counting Mode: %s\n", sim_options.per_step_collisions ? "per step" : "per contact episode");
+
     fprintf(report_file, "\nCollision Event Log (%d entries):\n", collision_log_index);
     if (collision_log_index == 0) {
         fprintf(report_file, "  No collisions occurred during the simulation.\n");
@@ -122,11 +183,54 @@ void log_simulation_summary_to_report(int final_time_step, int simulation_status
         for (int i = 0; i < collision_log_index; ++i) {
             char time_str_buffer[30];
             strftime(time_str_buffer, sizeof(time_str_buffer), "%Y-%m-%d %H:%M:%S", localtime(&collision_log[i].timestamp));
-            fprintf(report_file, "  Event %d: Time Step %d, Drones %d & %d at (%d, %d, %d), Logged at: %s\n",
-                    i + 1, collision_log[i].time_step,
-                    collision_log[i].drone_id1, collision_log[i].drone_id2,
-                    collision_log[i].x, collision_log[i].y, collision_log[i].z,
-                    time_str_buffer);
+            if (sim_options.per_step_collisions) {
+                fprintf(report_file, "  Event %d: Time Step %d, Drones %d & %d at (%d, %d, %d), Logged at: %s\n",
+                        i + 1, collision_log[i].time_step,
+                        collision_log[i].drone_id1, collision_log[i].drone_id2,
+                        collision_log[i].x, collision_log[i].y, collision_log[i].z,
+                        time_str_buffer);
+            } else {
+                fprintf(report_file, "  Episode %d: Time Steps %d-%d (%d step(s), %d cell change(s)), Drones %d & %d, last at (%d, %d, %d), Logged at: %s\n",
+                        i + 1, collision_log[i].time_step, collision_log[i].end_step,
+                        collision_log[i].end_step - collision_log[i].time_step + 1,
+                        collision_log[i].cell_changes,
+                        collision_log[i].drone_id1, collision_log[i].drone_id2,
+                        collision_log[i].x, collision_log[i].y, collision_log[i].z,
+                        time_str_buffer);
+            }
+        }
+    }
+    if (contact_tracker_dropped_count() > 0) {
+        fprintf(report_file, "  (%d collision record(s) dropped: pending queue full)\n", contact_tracker_dropped_count());
+    }
+
+    // Post-run analytics are answered from the recorded position history, not by re-simulating.
+    fprintf(report_file, "\n--- Trajectory Analytics (position history) ---\n");
+    if (position_history.num_steps == 0) {
+        fprintf(report_file, "  Position history not available.\n");
+    } else {
+        size_t raw_bytes = (size_t)position_history.num_steps * num_sim_drones * 3 * sizeof(int);
+        fprintf(report_file, "  History: %d steps, %d keyframes, %zu bytes (uncompressed: %zu bytes)\n",
+                position_history.num_steps, position_history.num_keyframes,
+                position_history_memory_bytes(&position_history), raw_bytes);
+        if (position_history.disabled) {
+            fprintf(report_file, "  (recording stopped after Time Step %d; later collisions are not analysed)\n",
+                    position_history.num_steps - 1);
+        }
+        for (int i = 0; i < collision_log_index; ++i) {
+            const CollisionEvent* ev = &collision_log[i];
+            int nearby[MAX_DRONES];
+            // The logged cell is the episode's last one (the collision cell in per-step mode): query at end_step.
+            int found = position_history_query_box(&position_history, ev->end_step,
+                                                   ev->x - 1, ev->x + 1, ev->y - 1, ev->y + 1, ev->z - 1, ev->z + 1,
+                                                   nearby, MAX_DRONES);
+            if (found < 0) continue;
+            fprintf(report_file, "  Collision entry %d (Time Step %d): drones within 1 cell of (%d, %d, %d):",
+                    i + 1, ev->end_step, ev->x, ev->y, ev->z);
+            for (int k = 0; k < found && k < MAX_DRONES; ++k) {
+                fprintf(report_file, " %d", sim_drones[nearby[k]].id);
+            }
+            fprintf(report_file, "\n");
         }
     }
 
@@ -134,10 +238,59 @@ void log_simulation_summary_to_report(int final_time_step, int simulation_status
     fprintf(report_file, "\n--- Final Drone Statuses ---\n");
     for (int i = 0; i < num_sim_drones; ++i) {
         // Reads the final state directly from shared memory
-        const char* status = shared_mem->drones[i].finished ? "COMPLETED" : "NOT COMPLETED";
+        LatencySummary latency;
+        latency_monitor_summary(i, &latency);
+        const char* status = shared_mem->drones[i].finished ? "COMPLETED"
+                           : latency.deactivated ? "DEACTIVATED (missed step deadline)" : "NOT COMPLETED";
         fprintf(report_file, "  Drone ID %2d: %s\n", shared_mem->drones[i].id, status);
     }
 
+    // Maintained incrementally during the run; merging is O(1) per drone.
+    fprintf(report_file, "\n--- Per-Drone Statistics ---\n");
+    fprintf(report_file, "  %-8s %8s %10s", "Drone ID", "Distance", "Collisions");
+    for (int b = 0; b < ALTITUDE_BAND_COUNT; ++b) {
+        char band_label[16];
+        if (b < ALTITUDE_BAND_COUNT - 1) {
+            snprintf(band_label, sizeof(band_label), "z%d-%d", b * ALTITUDE_BAND_HEIGHT, (b + 1) * ALTITUDE_BAND_HEIGHT - 1);
+        } else {
+            snprintf(band_label, sizeof(band_label), "z%d+", b * ALTITUDE_BAND_HEIGHT);
+        }
+        fprintf(report_file, " %7s", band_label);
+    }
+    fprintf(report_file, " %14s\n", "Min Separation");
+    for (int i = 0; i < num_sim_drones; ++i) {
+        DroneStats stats;
+        drone_stats_merge(i, &stats);
+        fprintf(report_file, "  %-8d %8d %10d", stats.id, stats.distance_travelled, stats.collisions);
+        for (int b = 0; b < ALTITUDE_BAND_COUNT; ++b) fprintf(report_file, " %7d", stats.steps_in_band[b]);
+        if (stats.nearest_drone_id >= 0) {
+            fprintf(report_file, " %7.2f (ID %d)\n", stats.min_separation, stats.nearest_drone_id);
+        } else {
+            fprintf(report_file, " %14s\n", "n/a");
+        }
+    }
+
+    fprintf(report_file, "\n--- Drone Response Latency (step deadline: ");
+    if (sim_options.step_deadline_ms > 0) fprintf(report_file, "%d ms", sim_options.step_deadline_ms);
+    else fprintf(report_file, "none");
+    fprintf(report_file, ") ---\n");
+    int any_censored = 0;
+    for (int i = 0; i < num_sim_drones; ++i) {
+        LatencySummary latency;
+        latency_monitor_summary(i, &latency);
+        fprintf(report_file, "  Drone ID %2d: %3d samples, p50 %s%9.1f us, p99 %s%9.1f us, max %s%9.1f us, "
+                "deadline misses %d, skipped steps %d",
+                shared_mem->drones[i].id, latency.samples,
+                latency.p50_lower_bound ? ">=" : "  ", latency.p50_ns / 1000.0,
+                latency.p99_lower_bound ? ">=" : "  ", latency.p99_ns / 1000.0,
+                latency.max_lower_bound ? ">=" : "  ", latency.max_ns / 1000.0,
+                latency.deadline_misses, latency.skipped_steps);
+        if (latency.censored > 0) fprintf(report_file, ", %d unanswered", latency.censored);
+        any_censored |= latency.censored > 0;
+        fprintf(report_file, "\n");
+    }
+    if (any_censored) fprintf(report_file, "  (\">=\": lower bound; unanswered steps count as the time waited for them)\n");
+
 
     fprintf(report_file, "\nOverall Simulation Status: ");
     switch (simulation_status_code) {
@@ -0,0 +1,189 @@
+// shm_bench.c
+// Benchmark for the shared-memory segment options (see shm_segment.c).
+// For each configuration it reports:
+//   - startup time: create/map the segment and have every forked worker attach and
+//     first-touch its partition, as the drone children do;
+//   - dTLB misses and per-step time while workers write random cache lines in their partitions
+//     (step time is the slowest worker's loop, excluding fork and attach).
+// Usage: ./shm_bench [--size-mb=N] [--workers=N] [--steps=N] [--writes=N]
+#define _GNU_SOURCE // For syscall and perf_event_open
+#include "shm_segment.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#define BENCH_SHM_NAME "/drone_sim_bench_shm"
+#define BENCH_CACHE_LINE 64
+
+typedef struct {
+    const char* label;
+    ShmSegmentOptions opts;
+} BenchConfig;
+
+typedef struct {
+    size_t size_bytes;
+    int workers;
+    int steps;
+    int writes_per_step;
+} BenchParams;
+
+static long long bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Opens a user-space dTLB miss counter for this process and its future children.
+static int open_dtlb_counter(int op) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | ((unsigned long long)op << 8) |
+                  ((unsigned long long)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Worker `w`: attach, then either first-touch its partition (steps == 0) or run the step loop.
+// The time spent in the loop (excluding fork and attach) is written to `result_fd`.
+static void bench_worker(const ShmSegment* seg, const BenchConfig* config, const BenchParams* params,
+                         int w, int steps, int result_fd) {
+    if (config->opts.numa_bind) shm_segment_pin_to_partition_node(w, params->workers);
+
+    ShmSegment view;
+    if (!shm_segment_attach(seg, &view)) _exit(EXIT_FAILURE);
+
+    size_t partition = params->size_bytes / (size_t)params->workers / BENCH_CACHE_LINE * BENCH_CACHE_LINE;
+    volatile char* base = (volatile char*)view.addr + partition * (size_t)w;
+    size_t lines = partition / BENCH_CACHE_LINE;
+
+    long long start = bench_now_ns();
+    if (steps == 0) {
+        for (size_t off = 0; off < partition; off += 4096) base[off] = 1;
+    } else {
+        unsigned long long lcg = 0x9E3779B97F4A7C15ULL * (unsigned long long)(w + 1);
+        for (int s = 0; s < steps; ++s) {
+            for (int k = 0; k < params->writes_per_step; ++k) {
+                lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+                base[((lcg >> 17) % lines) * BENCH_CACHE_LINE] += 1;
+            }
+        }
+    }
+    long long elapsed = bench_now_ns() - start;
+    ssize_t written = write(result_fd, &elapsed, sizeof(elapsed));
+    shm_segment_detach(&view);
+    _exit(written == sizeof(elapsed) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+// Runs all workers to completion. Returns 1 if all succeeded; `slowest_ns` (if not NULL)
+// receives the longest in-worker loop time.
+static int run_workers(const ShmSegment* seg, const BenchConfig* config, const BenchParams* params,
+                       int steps, long long* slowest_ns) {
+    int result_pipe[2];
+    if (pipe(result_pipe) == -1) return 0;
+
+    pid_t pids[256];
+    int started = 0;
+    for (int w = 0; w < params->workers && w < 256; ++w) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(result_pipe[0]);
+            bench_worker(seg, config, params, w, steps, result_pipe[1]);
+        }
+        if (pid < 0) break;
+        pids[started++] = pid;
+    }
+    close(result_pipe[1]);
+
+    int ok = started == params->workers;
+    long long slowest = 0, elapsed;
+    while (read(result_pipe[0], &elapsed, sizeof(elapsed)) == sizeof(elapsed)) {
+        if (elapsed > slowest) slowest = elapsed;
+    }
+    if (slowest_ns) *slowest_ns = slowest;
+    close(result_pipe[0]);
+    for (int i = 0; i < started; ++i) {
+        int status = 0;
+        waitpid(pids[i], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = 0;
+    }
+    return ok;
+}
+
+static void run_config(const BenchConfig* config, const BenchParams* params) {
+    ShmSegment seg;
+    long long t0 = bench_now_ns();
+    if (!shm_segment_create(&seg, BENCH_SHM_NAME, params->size_bytes, &config->opts)) {
+        printf("%-24s  (segment creation failed)\n", config->label);
+        return;
+    }
+    if (config->opts.numa_bind) {
+        size_t stride = params->size_bytes / (size_t)params->workers;
+        shm_segment_bind_partitions(&seg, 0, stride, params->workers);
+        if (config->opts.prefault) shm_segment_prefault(&seg);
+    }
+    int ok = run_workers(&seg, config, params, 0, NULL);
+    long long t1 = bench_now_ns();
+
+    int fd_read = open_dtlb_counter(PERF_COUNT_HW_CACHE_OP_READ);
+    int fd_write = open_dtlb_counter(PERF_COUNT_HW_CACHE_OP_WRITE);
+    if (fd_read >= 0) ioctl(fd_read, PERF_EVENT_IOC_ENABLE, 0);
+    if (fd_write >= 0) ioctl(fd_write, PERF_EVENT_IOC_ENABLE, 0);
+    long long step_loop_ns;
+    ok = run_workers(&seg, config, params, params->steps, &step_loop_ns) && ok;
+    if (fd_read >= 0) ioctl(fd_read, PERF_EVENT_IOC_DISABLE, 0);
+    if (fd_write >= 0) ioctl(fd_write, PERF_EVENT_IOC_DISABLE, 0);
+
+    char tlb_text[32] = "n/a";
+    unsigned long long misses = 0, value = 0;
+    int have_counter = 0;
+    if (fd_read >= 0 && read(fd_read, &value, sizeof(value)) == sizeof(value)) { misses += value; have_counter = 1; }
+    if (fd_write >= 0 && read(fd_write, &value, sizeof(value)) == sizeof(value)) { misses += value; have_counter = 1; }
+    if (have_counter) snprintf(tlb_text, sizeof(tlb_text), "%llu", misses);
+    if (fd_read >= 0) close(fd_read);
+    if (fd_write >= 0) close(fd_write);
+
+    printf("%-24s  %-16s  %10.3f  %12.2f  %14s%s\n",
+           config->label, shm_segment_backing_name(&seg),
+           (t1 - t0) / 1e6, step_loop_ns / 1e3 / params->steps, tlb_text,
+           ok ? "" : "  (worker failure)");
+    shm_segment_destroy(&seg);
+}
+
+int main(int argc, char *argv[]) {
+    BenchParams params = { .size_bytes = 64u << 20, .workers = 4, .steps = 200, .writes_per_step = 4096 };
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--size-mb=", 10) == 0) params.size_bytes = (size_t)atoi(argv[i] + 10) << 20;
+        else if (strncmp(argv[i], "--workers=", 10) == 0) params.workers = atoi(argv[i] + 10);
+        else if (strncmp(argv[i], "--steps=", 8) == 0) params.steps = atoi(argv[i] + 8);
+        else if (strncmp(argv[i], "--writes=", 9) == 0) params.writes_per_step = atoi(argv[i] + 9);
+        else {
+            fprintf(stderr, "Usage: %s [--size-mb=N] [--workers=N] [--steps=N] [--writes=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (params.size_bytes == 0 || params.workers <= 0 || params.workers > 256 ||
+        params.steps <= 0 || params.writes_per_step <= 0) {
+        fprintf(stderr, "SHM_BENCH: All parameters must be positive (at most 256 workers).\n");
+        return EXIT_FAILURE;
+    }
+
+    const BenchConfig configs[] = {
+        { "default",               { .huge_pages = 0, .prefault = 0, .numa_bind = 0 } },
+        { "prefault",              { .huge_pages = 0, .prefault = 1, .numa_bind = 0 } },
+        { "hugepages",             { .huge_pages = 1, .prefault = 0, .numa_bind = 0 } },
+        { "hugepages+prefault",    { .huge_pages = 1, .prefault = 1, .numa_bind = 0 } },
+        { "hugepages+prefault+numa", { .huge_pages = 1, .prefault = 1, .numa_bind = 1 } },
+    };
+
+    printf("Segment %zu MiB, %d workers, %d steps x %d random writes per worker, %d NUMA node(s)\n\n",
+           params.size_bytes >> 20, params.workers, params.steps, params.writes_per_step,
+           shm_segment_numa_node_count());
+    printf("%-24s  %-16s  %10s  %12s  %14s\n", "Config", "Backing", "Startup ms", "Step us", "dTLB misses");
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); ++i) run_config(&configs[i], &params);
+    return EXIT_SUCCESS;
+}
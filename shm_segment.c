@@ -0,0 +1,242 @@
+// shm_segment.c
+#define _GNU_SOURCE // For MAP_HUGETLB, MAP_POPULATE, madvise, sched_setaffinity and syscall
+#include "shm_segment.h"
+#include <sched.h>
+#include <sys/syscall.h>
+
+// mbind(2) constants, so the build does not depend on libnuma headers.
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+#define SHM_MAX_NUMA_NODES 64
+
+// Huge page size from /proc/meminfo, or 2 MiB if it cannot be read.
+static size_t huge_page_size(void) {
+    size_t size_kb = 2048;
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo) {
+        char line[BUFFER_SIZE];
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (sscanf(line, "Hugepagesize: %zu kB", &size_kb) == 1) break;
+        }
+        fclose(meminfo);
+    }
+    return size_kb * 1024;
+}
+
+static size_t round_up(size_t bytes, size_t page) {
+    return (bytes + page - 1) / page * page;
+}
+
+// Maps the named POSIX segment with `extra_flags`; creates and sizes it if `create`.
+static void* map_named(const char* name, size_t size, int create, int extra_flags) {
+    int shm_fd = shm_open(name, create ? (O_CREAT | O_RDWR) : O_RDWR, 0666);
+    if (shm_fd == -1) return MAP_FAILED;
+    if (create && ftruncate(shm_fd, (off_t)size) == -1) {
+        close(shm_fd);
+        return MAP_FAILED;
+    }
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | extra_flags, shm_fd, 0);
+    close(shm_fd);
+    return addr;
+}
+
+int shm_segment_create(ShmSegment* seg, const char* name, size_t bytes, const ShmSegmentOptions* opts) {
+    memset(seg, 0, sizeof(*seg));
+    snprintf(seg->name, sizeof(seg->name), "%s", name);
+    seg->prefault = opts->prefault;
+    // Populating at mmap time would place pages before NUMA binding, so defer it in that case.
+    int populate_flag = (opts->prefault && !opts->numa_bind) ? MAP_POPULATE : 0;
+
+    if (opts->huge_pages) {
+        size_t page = huge_page_size();
+        size_t size = round_up(bytes, page);
+        void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS | MAP_HUGETLB | populate_flag, -1, 0);
+        if (addr != MAP_FAILED) {
+            seg->addr = addr;
+            seg->size = size;
+            seg->page_size = page;
+            seg->backing = SHM_BACKING_HUGETLB;
+            seg->separately_mapped = 1;
+            seg->name[0] = '\0'; // Nothing to unlink; children inherit the mapping
+            return 1;
+        }
+
+        // No hugetlb pages reserved: fall back to a named segment advised for THP.
+        shm_unlink(name);
+        addr = map_named(name, size, 1, 0);
+        if (addr == MAP_FAILED) {
+            perror("SHM_SEGMENT: Error creating shared memory");
+            return 0;
+        }
+        madvise(addr, size, MADV_HUGEPAGE);
+        seg->addr = addr;
+        seg->size = size;
+        seg->page_size = page;
+        seg->backing = SHM_BACKING_THP;
+        seg->separately_mapped = 1;
+        // THP only collapses pages faulted after the advice, so populate by touching.
+        if (populate_flag) shm_segment_prefault(seg);
+        return 1;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = round_up(bytes, page);
+    shm_unlink(name);
+    void* addr = map_named(name, size, 1, populate_flag);
+    if (addr == MAP_FAILED) {
+        perror("SHM_SEGMENT: Error creating shared memory");
+        return 0;
+    }
+    seg->addr = addr;
+    seg->size = size;
+    seg->page_size = page;
+    seg->backing = SHM_BACKING_DEFAULT;
+    seg->separately_mapped = 1;
+    return 1;
+}
+
+int shm_segment_attach(const ShmSegment* parent_seg, ShmSegment* child_view) {
+    *child_view = *parent_seg;
+    if (parent_seg->backing == SHM_BACKING_HUGETLB) {
+        child_view->separately_mapped = 0; // Inherited across fork()
+        return 1;
+    }
+    void* addr = map_named(parent_seg->name, parent_seg->size, 0, parent_seg->prefault ? MAP_POPULATE : 0);
+    if (addr == MAP_FAILED) return 0;
+    child_view->addr = addr;
+    child_view->separately_mapped = 1;
+    return 1;
+}
+
+void shm_segment_detach(ShmSegment* child_view) {
+    if (child_view->addr && child_view->separately_mapped) munmap(child_view->addr, child_view->size);
+    child_view->addr = NULL;
+}
+
+void shm_segment_destroy(ShmSegment* seg) {
+    if (seg->addr && seg->separately_mapped) munmap(seg->addr, seg->size);
+    if (seg->name[0] != '\0') shm_unlink(seg->name);
+    seg->addr = NULL;
+}
+
+void shm_segment_prefault(ShmSegment* seg) {
+    // Write-touch in base-page steps: also correct (just redundant) for huge pages.
+    size_t step = (size_t)sysconf(_SC_PAGESIZE);
+    volatile char* bytes = seg->addr;
+    for (size_t off = 0; off < seg->size; off += step) bytes[off] = bytes[off];
+}
+
+int shm_segment_numa_node_count(void) {
+    static int cached_count = 0; // Topology does not change during a run
+    if (cached_count > 0) return cached_count;
+
+    int count = 0;
+    char path[BUFFER_SIZE];
+    for (int node = 0; node < SHM_MAX_NUMA_NODES; ++node) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", node);
+        if (access(path, F_OK) == 0) count = node + 1;
+    }
+    cached_count = count > 0 ? count : 1;
+    return cached_count;
+}
+
+int shm_segment_partition_node(int partition, int partitions) {
+    int nodes = shm_segment_numa_node_count();
+    if (partitions <= 0) return 0;
+    return (int)((long long)partition * nodes / partitions);
+}
+
+// The partition owning the first byte of the page at `page_start` (clamped to the partitioned range).
+static int page_owner_partition(size_t page_start, size_t offset, size_t stride) {
+    size_t first = page_start < offset ? offset : page_start;
+    return (int)((first - offset) / stride);
+}
+
+int shm_segment_bind_partitions(ShmSegment* seg, size_t offset, size_t stride, int partitions) {
+    int nodes = shm_segment_numa_node_count();
+    if (nodes <= 1 || partitions <= 0 || stride == 0) return 0; // Nothing to place
+
+    int bound = 0;
+    size_t end = offset + stride * (size_t)partitions;
+    for (size_t page_start = offset / seg->page_size * seg->page_size; page_start < end; page_start += seg->page_size) {
+        unsigned long nodemask[SHM_MAX_NUMA_NODES / (8 * sizeof(unsigned long)) + 1] = {0};
+        int node = shm_segment_partition_node(page_owner_partition(page_start, offset, stride), partitions);
+        nodemask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        if (syscall(SYS_mbind, (char*)seg->addr + page_start, seg->page_size, MPOL_PREFERRED,
+                    nodemask, (unsigned long)SHM_MAX_NUMA_NODES, MPOL_MF_MOVE) == 0) {
+            bound++;
+        }
+    }
+    return bound;
+}
+
+int shm_segment_partitions_separable(const ShmSegment* seg, size_t offset, size_t stride, int partitions) {
+    if (partitions <= 0 || stride == 0) return 0;
+    size_t end = offset + stride * (size_t)partitions;
+    for (size_t page_start = offset / seg->page_size * seg->page_size; page_start < end; page_start += seg->page_size) {
+        size_t page_last = page_start + seg->page_size - 1;
+        if (page_last >= end) page_last = end - 1;
+        int first_node = shm_segment_partition_node(page_owner_partition(page_start, offset, stride), partitions);
+        int last_node = shm_segment_partition_node((int)((page_last - offset) / stride), partitions);
+        if (first_node != last_node) return 0;
+    }
+    return 1;
+}
+
+// Parses a sysfs cpulist such as "0-3,8-11" into `set`.
+static int parse_cpulist(const char* list, cpu_set_t* set) {
+    int added = 0;
+    const char* p = list;
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET((int)cpu, set);
+            added++;
+        }
+        p = (*end == ',') ? end + 1 : end;
+        if (*p == '\n') break;
+    }
+    return added;
+}
+
+static int pin_to_node(int node) {
+    if (shm_segment_numa_node_count() <= 1) return 1; // Any CPU is local
+
+    char path[BUFFER_SIZE];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+    char list[BUFFER_SIZE];
+    int ok = fgets(list, sizeof(list), file) != NULL;
+    fclose(file);
+    if (!ok) return 0;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (parse_cpulist(list, &set) == 0) return 0;
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+int shm_segment_pin_to_partition_node(int partition, int partitions) {
+    return pin_to_node(shm_segment_partition_node(partition, partitions));
+}
+
+const char* shm_segment_backing_name(const ShmSegment* seg) {
+    switch (seg->backing) {
+        case SHM_BACKING_HUGETLB: return "hugetlb";
+        case SHM_BACKING_THP: return "THP-advised shm";
+        default: return "base-page shm";
+    }
+}
@@ -0,0 +1,69 @@
+// shm_segment.h
+#ifndef SHM_SEGMENT_H
+#define SHM_SEGMENT_H
+
+#include "drone_simulation.h" // For ShmSegmentOptions
+
+// How a segment's pages are backed.
+typedef enum {
+    SHM_BACKING_DEFAULT,   // POSIX shm (tmpfs), base pages
+    SHM_BACKING_HUGETLB,   // Anonymous shared MAP_HUGETLB mapping, inherited by forked children
+    SHM_BACKING_THP        // POSIX shm with MADV_HUGEPAGE (effective if shmem THP is enabled)
+} ShmBacking;
+
+// A mapped shared-memory segment. Children forked after creation attach through
+// shm_segment_attach, which maps the named segment again or, for anonymous
+// hugetlb segments, reuses the mapping inherited across fork().
+typedef struct {
+    void* addr;
+    size_t size;              // Mapped bytes, rounded up to page_size
+    size_t page_size;
+    ShmBacking backing;
+    int separately_mapped;    // 1 if this view owns its own mmap (must be unmapped)
+    int prefault;             // Children populate their mapping with MAP_POPULATE
+    char name[64];            // POSIX shm name ("" for anonymous segments)
+} ShmSegment;
+
+// The simulation's segment (defined in main_controller.c, inherited by children).
+extern ShmSegment shm_segment;
+
+// Creates and maps a zero-filled segment of at least `bytes`. With huge pages requested,
+// hugetlb is tried first, then POSIX shm with MADV_HUGEPAGE. With prefault requested
+// (and no NUMA binding, which must happen before first touch) pages are populated
+// at creation. Returns 1 on success, 0 on failure.
+int shm_segment_create(ShmSegment* seg, const char* name, size_t bytes, const ShmSegmentOptions* opts);
+
+// Maps the segment in a forked child. Returns 1 on success, 0 on failure.
+int shm_segment_attach(const ShmSegment* parent_seg, ShmSegment* child_view);
+
+// Undoes shm_segment_attach.
+void shm_segment_detach(ShmSegment* child_view);
+
+// Unmaps the segment and removes its name.
+void shm_segment_destroy(ShmSegment* seg);
+
+// Writes one byte per page so every page is resident before the simulation starts.
+void shm_segment_prefault(ShmSegment* seg);
+
+// Number of NUMA nodes with memory (1 on non-NUMA systems).
+int shm_segment_numa_node_count(void);
+
+// NUMA node that writer `partition` of `partitions` is assigned to (contiguous blocks).
+int shm_segment_partition_node(int partition, int partitions);
+
+// Binds the pages of `partitions` equally-strided partitions starting at `offset` to their
+// writers' nodes. A page shared by two partitions goes to the one owning its first byte.
+// Must run before the pages are first touched. Returns the number of pages bound.
+int shm_segment_bind_partitions(ShmSegment* seg, size_t offset, size_t stride, int partitions);
+
+// Returns 1 if no page holds partitions assigned to different nodes, i.e. binding places
+// every partition on its writer's node. Partitions smaller than a page usually are not.
+int shm_segment_partitions_separable(const ShmSegment* seg, size_t offset, size_t stride, int partitions);
+
+// Restricts the calling process to the CPUs of its partition's node. Returns 1 on success.
+int shm_segment_pin_to_partition_node(int partition, int partitions);
+
+// Human-readable backing description for logs.
+const char* shm_segment_backing_name(const ShmSegment* seg);
+
+#endif // SHM_SEGMENT_H
@@ -0,0 +1,227 @@
+// step_kernel.c
+#include "step_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STEP_KERNEL_HAVE_AVX2 1
+#endif
+
+// Per-command movement deltas, indexed by CommandType. Mirrors the switch in
+// drone_child_process: SHAKE, ROTATE, UNKNOWN and END leave the drone in place.
+// Sized 8 so the AVX2 path can use the first row as a permute table.
+static const int32_t step_delta_x[8] = { [CMD_LEFT] = -1, [CMD_RIGHT] = 1 };
+static const int32_t step_delta_y[8] = { [CMD_FORWARD] = 1, [CMD_BACKWARD] = -1 };
+static const int32_t step_delta_z[8] = { [CMD_UP] = 1, [CMD_DOWN] = -1 };
+
+typedef int (*StepKernelFn)(StepKernelBatch* batch, const uint8_t* row, int32_t next_step);
+
+// Allocates `bytes` rounded up to a 32-byte multiple, 32-byte aligned, zero-filled.
+static void* step_kernel_alloc(size_t bytes) {
+    size_t rounded = (bytes + 31) & ~(size_t)31;
+    if (rounded == 0) rounded = 32;
+    void* ptr = aligned_alloc(32, rounded);
+    if (ptr) memset(ptr, 0, rounded);
+    return ptr;
+}
+
+// Portable implementation, also used for the tail of the AVX2 loop.
+static int step_kernel_scalar(StepKernelBatch* batch, const uint8_t* row, int32_t next_step, int start) {
+    int still_active = 0;
+    for (int i = start; i < batch->capacity; ++i) {
+        if (!batch->active[i]) continue;
+        uint8_t cmd = row ? row[i] : CMD_END;
+        if (cmd < 8) {
+            batch->x[i] += step_delta_x[cmd];
+            batch->y[i] += step_delta_y[cmd];
+            batch->z[i] += step_delta_z[cmd];
+        }
+        if (batch->num_instructions[i] <= next_step) {
+            batch->finished[i] = 1;
+            batch->active[i] = 0;
+        } else {
+            still_active++;
+        }
+    }
+    return still_active;
+}
+
+static int step_kernel_scalar_entry(StepKernelBatch* batch, const uint8_t* row, int32_t next_step) {
+    return step_kernel_scalar(batch, row, next_step, 0);
+}
+
+#ifdef STEP_KERNEL_HAVE_AVX2
+// Eight drones per iteration: the command bytes are widened to lanes, used as
+// indices into the delta tables with a cross-lane permute, masked by the active
+// flags and added to the positions. Finished/active are recomputed from masks.
+__attribute__((target("avx2")))
+static int step_kernel_avx2(StepKernelBatch* batch, const uint8_t* row, int32_t next_step) {
+    const __m256i table_x = _mm256_loadu_si256((const __m256i*)step_delta_x);
+    const __m256i table_y = _mm256_loadu_si256((const __m256i*)step_delta_y);
+    const __m256i table_z = _mm256_loadu_si256((const __m256i*)step_delta_z);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i eight = _mm256_set1_epi32(8);
+    const __m256i step_vec = _mm256_set1_epi32(next_step);
+    int still_active = 0;
+
+    int i = 0;
+    for (; i + STEP_KERNEL_LANES <= batch->capacity; i += STEP_KERNEL_LANES) {
+        __m256i active = _mm256_load_si256((const __m256i*)(batch->active + i));
+        __m256i active_mask = _mm256_cmpeq_epi32(active, one);
+        if (_mm256_testz_si256(active_mask, active_mask)) continue;
+
+        __m256i cmd = row ? _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row + i)))
+                          : _mm256_set1_epi32(CMD_END);
+        // Commands >= 8 (UNKNOWN/END) would wrap in the permute, so mask them out.
+        __m256i move_mask = _mm256_and_si256(active_mask, _mm256_cmpgt_epi32(eight, cmd));
+
+        __m256i dx = _mm256_and_si256(_mm256_permutevar8x32_epi32(table_x, cmd), move_mask);
+        __m256i dy = _mm256_and_si256(_mm256_permutevar8x32_epi32(table_y, cmd), move_mask);
+        __m256i dz = _mm256_and_si256(_mm256_permutevar8x32_epi32(table_z, cmd), move_mask);
+
+        __m256i* px = (__m256i*)(batch->x + i);
+        __m256i* py = (__m256i*)(batch->y + i);
+        __m256i* pz = (__m256i*)(batch->z + i);
+        _mm256_store_si256(px, _mm256_add_epi32(_mm256_load_si256(px), dx));
+        _mm256_store_si256(py, _mm256_add_epi32(_mm256_load_si256(py), dy));
+        _mm256_store_si256(pz, _mm256_add_epi32(_mm256_load_si256(pz), dz));
+
+        // done: num_instructions <= next_step, restricted to lanes that were active.
+        __m256i remaining = _mm256_load_si256((const __m256i*)(batch->num_instructions + i));
+        __m256i not_done = _mm256_cmpgt_epi32(remaining, step_vec);
+        __m256i done_mask = _mm256_andnot_si256(not_done, active_mask);
+
+        __m256i* pf = (__m256i*)(batch->finished + i);
+        _mm256_store_si256(pf, _mm256_or_si256(_mm256_load_si256(pf), _mm256_and_si256(done_mask, one)));
+        __m256i new_active_mask = _mm256_andnot_si256(done_mask, active_mask);
+        _mm256_store_si256((__m256i*)(batch->active + i), _mm256_and_si256(new_active_mask, one));
+
+        still_active += __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(new_active_mask)));
+    }
+    // capacity is a multiple of STEP_KERNEL_LANES, so this only runs if that ever changes.
+    return still_active + step_kernel_scalar(batch, row, next_step, i);
+}
+#endif
+
+static StepKernelFn step_kernel_impl = NULL;
+static const char* step_kernel_impl_name = "scalar";
+
+static void step_kernel_select_backend(void) {
+    if (step_kernel_impl) return;
+    step_kernel_impl = step_kernel_scalar_entry;
+    step_kernel_impl_name = "scalar";
+#ifdef STEP_KERNEL_HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        step_kernel_impl = step_kernel_avx2;
+        step_kernel_impl_name = "avx2";
+    }
+#endif
+}
+
+int step_kernel_force_backend(const char* name) {
+    if (strcmp(name, "scalar") == 0) {
+        step_kernel_impl = step_kernel_scalar_entry;
+        step_kernel_impl_name = "scalar";
+        return 1;
+    }
+#ifdef STEP_KERNEL_HAVE_AVX2
+    __builtin_cpu_init();
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        step_kernel_impl = step_kernel_avx2;
+        step_kernel_impl_name = "avx2";
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+const char* step_kernel_backend_name(void) {
+    step_kernel_select_backend();
+    return step_kernel_impl_name;
+}
+
+int step_kernel_init(StepKernelBatch* batch, int drone_count, int num_steps) {
+    memset(batch, 0, sizeof(*batch));
+    if (drone_count < 0 || num_steps < 0) return 0;
+
+    batch->count = drone_count;
+    batch->capacity = (drone_count + STEP_KERNEL_LANES - 1) / STEP_KERNEL_LANES * STEP_KERNEL_LANES;
+    batch->num_steps = num_steps;
+    batch->current_step = 0;
+
+    size_t lane_bytes = (size_t)batch->capacity * sizeof(int32_t);
+    batch->ids = step_kernel_alloc(lane_bytes);
+    batch->x = step_kernel_alloc(lane_bytes);
+    batch->y = step_kernel_alloc(lane_bytes);
+    batch->z = step_kernel_alloc(lane_bytes);
+    batch->finished = step_kernel_alloc(lane_bytes);
+    batch->active = step_kernel_alloc(lane_bytes);
+    batch->num_instructions = step_kernel_alloc(lane_bytes);
+    batch->commands = step_kernel_alloc((size_t)num_steps * (size_t)batch->capacity);
+
+    if (!batch->ids || !batch->x || !batch->y || !batch->z || !batch->finished ||
+        !batch->active || !batch->num_instructions || !batch->commands) {
+        perror("STEP_KERNEL: Error allocating batch");
+        step_kernel_free(batch);
+        return 0;
+    }
+    memset(batch->commands, CMD_END, (size_t)num_steps * (size_t)batch->capacity);
+
+    step_kernel_select_backend();
+    return 1;
+}
+
+int step_kernel_load_drones(StepKernelBatch* batch, const Drone drones_arr[], int drone_count) {
+    int num_steps = 0;
+    for (int i = 0; i < drone_count; ++i) {
+        if (drones_arr[i].num_instructions > num_steps) num_steps = drones_arr[i].num_instructions;
+    }
+    if (!step_kernel_init(batch, drone_count, num_steps)) return 0;
+
+    for (int i = 0; i < drone_count; ++i) {
+        const Drone* d = &drones_arr[i];
+        batch->ids[i] = d->id;
+        batch->x[i] = d->initial_x;
+        batch->y[i] = d->initial_y;
+        batch->z[i] = d->initial_z;
+        batch->active[i] = 1;
+        batch->num_instructions[i] = d->num_instructions;
+        for (int t = 0; t < d->num_instructions; ++t) {
+            batch->commands[(size_t)t * batch->capacity + i] = (uint8_t)d->instructions[t];
+        }
+    }
+    return 1;
+}
+
+void step_kernel_free(StepKernelBatch* batch) {
+    free(batch->ids);
+    free(batch->x);
+    free(batch->y);
+    free(batch->z);
+    free(batch->finished);
+    free(batch->active);
+    free(batch->num_instructions);
+    free(batch->commands);
+    memset(batch, 0, sizeof(*batch));
+}
+
+int step_kernel_advance(StepKernelBatch* batch) {
+    step_kernel_select_backend();
+    // Past the last row every remaining drone is at or beyond the end of its plan.
+    const uint8_t* row = NULL;
+    if (batch->current_step < batch->num_steps) {
+        row = batch->commands + (size_t)batch->current_step * batch->capacity;
+    }
+    batch->current_step++;
+    return step_kernel_impl(batch, row, batch->current_step);
+}
+
+int step_kernel_run(StepKernelBatch* batch, int max_steps) {
+    int steps = 0;
+    int still_active = batch->count;
+    while (steps < max_steps && still_active > 0) {
+        still_active = step_kernel_advance(batch);
+        steps++;
+    }
+    return steps;
+}
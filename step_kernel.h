@@ -0,0 +1,58 @@
+// step_kernel.h
+#ifndef STEP_KERNEL_H
+#define STEP_KERNEL_H
+
+#include <stdint.h>
+#include "drone_simulation.h" // For Drone, CommandType and MAX_INSTRUCTIONS
+
+// Number of drones processed per vector iteration (8 x int32 lanes in an AVX2 register).
+// Every per-drone array in a batch is padded to a multiple of this.
+#define STEP_KERNEL_LANES 8
+
+// Structure-of-arrays state for advancing many drones in-process, without
+// forking a child per drone. Positions and flags are contiguous per field so
+// one step is a handful of vector loads/stores per 8 drones.
+typedef struct {
+    int count;            // Number of real drones in the batch
+    int capacity;         // `count` rounded up to STEP_KERNEL_LANES (padding lanes stay inactive)
+    int num_steps;        // Longest flight plan in the batch (command rows allocated)
+    int current_step;     // Index of the next command row to execute
+
+    int32_t *ids;
+    int32_t *x, *y, *z;
+    int32_t *finished;             // 1 once the drone executed its last instruction
+    int32_t *active;               // 1 while the drone still takes part in steps
+    int32_t *num_instructions;
+
+    // Time-major command rows: commands[t * capacity + i] is drone i's command at step t.
+    // Steps past a drone's plan hold CMD_END, which has a zero delta.
+    uint8_t *commands;
+} StepKernelBatch;
+
+// Allocates an empty batch for `drone_count` drones and `num_steps` command rows.
+// All commands start as CMD_END and all drones inactive. Returns 1 on success, 0 on failure.
+int step_kernel_init(StepKernelBatch* batch, int drone_count, int num_steps);
+
+// Allocates a batch and fills it from parsed flight plans (as loaded by load_drones_from_csv).
+// Returns 1 on success, 0 on failure.
+int step_kernel_load_drones(StepKernelBatch* batch, const Drone drones_arr[], int drone_count);
+
+// Releases all memory owned by the batch.
+void step_kernel_free(StepKernelBatch* batch);
+
+// Executes one command row for every active drone and updates finished/active flags.
+// Returns the number of drones still active afterwards.
+int step_kernel_advance(StepKernelBatch* batch);
+
+// Advances up to `max_steps` rows or until no drone is active.
+// Returns the number of steps executed.
+int step_kernel_run(StepKernelBatch* batch, int max_steps);
+
+// Name of the implementation selected at runtime ("avx2" or "scalar"), for logs.
+const char* step_kernel_backend_name(void);
+
+// Overrides the runtime selection ("scalar" or "avx2"), e.g. to compare backends in
+// step_kernel_bench. Returns 0 if that backend is not built or not supported by the CPU.
+int step_kernel_force_backend(const char* name);
+
+#endif // STEP_KERNEL_H
@@ -0,0 +1,170 @@
+// step_kernel_bench.c
+// Equivalence and timing check for the batched step kernel (see step_kernel.c).
+// Random flight plans (including SHAKE/ROTATE/UNKNOWN/END commands and plans of every
+// length) are advanced with each available backend and compared step by step against
+// a plain reference that applies commands like drone_child_process. Then each backend
+// is timed on the same batch and its throughput reported in drone-steps per millisecond.
+// Exits non-zero if any backend disagrees with the reference.
+// Usage: ./step_kernel_bench [--drones=N] [--steps=N] [--seed=N]
+#define _GNU_SOURCE // For clock_gettime under -std=c11
+#include "step_kernel.h"
+
+typedef struct {
+    int drones;
+    int steps;
+    unsigned seed;
+} KernelBenchParams;
+
+static long long bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static unsigned next_random(unsigned* state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 8;
+}
+
+// Fills `batch` with a reproducible random workload for `params`.
+static int build_batch(StepKernelBatch* batch, const KernelBenchParams* params) {
+    if (!step_kernel_init(batch, params->drones, params->steps)) return 0;
+    unsigned state = params->seed;
+    for (int i = 0; i < params->drones; ++i) {
+        batch->ids[i] = i + 1;
+        batch->x[i] = (int)(next_random(&state) % 200) - 100;
+        batch->y[i] = (int)(next_random(&state) % 200) - 100;
+        batch->z[i] = (int)(next_random(&state) % 50);
+        batch->active[i] = 1;
+        batch->num_instructions[i] = (int)(next_random(&state) % (unsigned)(params->steps + 1));
+        for (int t = 0; t < batch->num_instructions[i]; ++t) {
+            batch->commands[(size_t)t * batch->capacity + i] = (uint8_t)(next_random(&state) % (CMD_END + 1));
+        }
+    }
+    return 1;
+}
+
+// Reference semantics: the drone_child_process switch, one drone and one step at a time.
+static void reference_step(const StepKernelBatch* plan, int32_t* x, int32_t* y, int32_t* z,
+                           int32_t* finished, int32_t* active, int step) {
+    for (int i = 0; i < plan->count; ++i) {
+        if (!active[i]) continue;
+        CommandType cmd = step < plan->num_steps ? (CommandType)plan->commands[(size_t)step * plan->capacity + i] : CMD_END;
+        switch (cmd) {
+            case CMD_UP: z[i]++; break;
+            case CMD_DOWN: z[i]--; break;
+            case CMD_LEFT: x[i]--; break;
+            case CMD_RIGHT: x[i]++; break;
+            case CMD_FORWARD: y[i]++; break;
+            case CMD_BACKWARD: y[i]--; break;
+            default: break;
+        }
+        if (step + 1 >= plan->num_instructions[i]) {
+            finished[i] = 1;
+            active[i] = 0;
+        }
+    }
+}
+
+// Advances a fresh batch with `backend` and compares every step with the reference.
+// Returns 1 if they agree.
+static int check_backend(const char* backend, const KernelBenchParams* params) {
+    StepKernelBatch batch;
+    if (!step_kernel_force_backend(backend) || !build_batch(&batch, params)) return 0;
+
+    size_t bytes = (size_t)batch.count * sizeof(int32_t);
+    int32_t* ref = malloc(bytes * 5);
+    if (!ref) {
+        step_kernel_free(&batch);
+        return 0;
+    }
+    int32_t *rx = ref, *ry = ref + batch.count, *rz = ref + 2 * batch.count;
+    int32_t *rf = ref + 3 * batch.count, *ra = ref + 4 * batch.count;
+    memcpy(rx, batch.x, bytes);
+    memcpy(ry, batch.y, bytes);
+    memcpy(rz, batch.z, bytes);
+    memcpy(rf, batch.finished, bytes);
+    memcpy(ra, batch.active, bytes);
+
+    int ok = 1;
+    for (int step = 0; step < params->steps + 1 && ok; ++step) {
+        int still_active = step_kernel_advance(&batch);
+        reference_step(&batch, rx, ry, rz, rf, ra, step);
+        int ref_active = 0;
+        for (int i = 0; i < batch.count; ++i) {
+            ref_active += ra[i];
+            if (batch.x[i] != rx[i] || batch.y[i] != ry[i] || batch.z[i] != rz[i] ||
+                batch.finished[i] != rf[i] || batch.active[i] != ra[i]) {
+                printf("  %s: drone %d differs at step %d: (%d,%d,%d f%d a%d) vs reference (%d,%d,%d f%d a%d)\n",
+                       backend, i, step, batch.x[i], batch.y[i], batch.z[i], batch.finished[i], batch.active[i],
+                       rx[i], ry[i], rz[i], rf[i], ra[i]);
+                ok = 0;
+                break;
+            }
+        }
+        if (ok && still_active != ref_active) {
+            printf("  %s: active count %d vs reference %d at step %d\n", backend, still_active, ref_active, step);
+            ok = 0;
+        }
+    }
+
+    free(ref);
+    step_kernel_free(&batch);
+    return ok;
+}
+
+// Times step_kernel_run over a fresh batch. Returns elapsed ns, or -1 on failure.
+static long long time_backend(const char* backend, const KernelBenchParams* params, long long* drone_steps) {
+    StepKernelBatch batch;
+    if (!step_kernel_force_backend(backend) || !build_batch(&batch, params)) return -1;
+    long long planned = 0;
+    for (int i = 0; i < batch.count; ++i) planned += batch.num_instructions[i] > 0 ? batch.num_instructions[i] : 1;
+
+    long long start = bench_now_ns();
+    step_kernel_run(&batch, params->steps + 1);
+    long long elapsed = bench_now_ns() - start;
+
+    *drone_steps = planned;
+    step_kernel_free(&batch);
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    KernelBenchParams params = { .drones = 8192, .steps = 250, .seed = 42 };
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--drones=", 9) == 0) params.drones = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--steps=", 8) == 0) params.steps = atoi(argv[i] + 8);
+        else if (strncmp(argv[i], "--seed=", 7) == 0) params.seed = (unsigned)strtoul(argv[i] + 7, NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s [--drones=N] [--steps=N] [--seed=N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (params.drones <= 0 || params.steps <= 0) {
+        fprintf(stderr, "STEP_KERNEL_BENCH: --drones and --steps must be positive.\n");
+        return EXIT_FAILURE;
+    }
+
+    const char* backends[] = { "scalar", "avx2" };
+    int failures = 0;
+    printf("Step kernel: %d drones, up to %d steps, seed %u\n\n", params.drones, params.steps, params.seed);
+    printf("%-8s  %-11s  %10s  %14s  %18s\n", "Backend", "Equivalence", "Run ms", "Drone-steps", "Drone-steps per ms");
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+        if (!step_kernel_force_backend(backends[b])) {
+            printf("%-8s  (not supported on this CPU)\n", backends[b]);
+            continue;
+        }
+        int ok = check_backend(backends[b], &params);
+        long long drone_steps = 0;
+        long long elapsed = time_backend(backends[b], &params, &drone_steps);
+        if (!ok) failures++;
+        if (elapsed < 0) {
+            printf("%-8s  %-11s  (allocation failed)\n", backends[b], ok ? "PASS" : "FAIL");
+            failures++;
+            continue;
+        }
+        printf("%-8s  %-11s  %10.3f  %14lld  %18.0f\n", backends[b], ok ? "PASS" : "FAIL",
+               elapsed / 1e6, drone_steps, elapsed > 0 ? drone_steps / (elapsed / 1e6) : 0.0);
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
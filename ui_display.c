@@ -1,6 +1,10 @@
 // ui_display.c
+#define _GNU_SOURCE // For clock_gettime and termios extensions under -std=c11
 #include "ui_display.h"
+#include "drone_stats.h" // For the altitude bands used to colour drones
 #include <stdio.h> // For printf
+#include <termios.h>
+#include <sys/ioctl.h>
 
 // --- Externs for accessing simulation state ---
 // `sim_drones` holds the initial configuration (e.g., total instructions).
@@ -98,4 +102,338 @@ void display_drone_summary_list(int current_time_step) {
                shared_mem->drones[i].instruction_executed_index + 1,                      // Live progress
                sim_drones[i].num_instructions);                                           // Total instructions from config
     }
-}
\ No newline at end of file
+}
+
+// --- Incremental (diff-based) renderer ---
+
+#define FRAME_LABEL_WIDTH 6   // "%5d|" row labels left of the grid
+#define FRAME_GRID_TOP_ROW 3  // Row 1: status line, row 2: top border
+#define CELL_UNDRAWN 0xFFFF   // Never equal to a real cell, forces a redraw
+
+// A frame cell: character in the low byte, colour index in the high byte.
+typedef unsigned short FrameCell;
+
+// Colour index 0 is the terminal default, 1..ALTITUDE_BAND_COUNT are altitude bands,
+// the last one marks cells holding several drones.
+static const char* const cell_colours[] = { "0", "32", "36", "33", "35", "1;31" };
+#define COLOUR_MULTIPLE 5
+
+static DisplayOptions view;
+static FrameCell* frame_current = NULL;
+static FrameCell* frame_previous = NULL;
+static int frame_width = 0, frame_height = 0;
+static int full_redraw_needed = 1;
+static long long last_frame_ns = 0;
+static char last_status_line[BUFFER_SIZE];
+
+// Positions copied out of shared memory by capture_drone_frame, drawn by draw_captured_frame.
+typedef struct { int id, x, y, z; } CapturedDrone;
+static CapturedDrone captured_drones[MAX_DRONES];
+static int captured_count = 0;
+static int captured_step = 0;
+static int frame_pending = 0;
+
+static char* out_buffer = NULL;
+static size_t out_length = 0, out_capacity = 0;
+
+static struct termios saved_termios;
+static volatile sig_atomic_t keyboard_enabled = 0; // Read by the signal handler
+static int renderer_active = 0;
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Floor division, so negative world coordinates map to the correct cell.
+static int floor_div(int a, int b) {
+    int q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+static void out_append(const char* format, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        int needed = vsnprintf(out_buffer + out_length, out_capacity - out_length, format, args);
+        va_end(args);
+        if (needed < 0) return;
+        if (out_length + (size_t)needed < out_capacity) {
+            out_length += (size_t)needed;
+            return;
+        }
+        size_t new_capacity = out_capacity * 2 + (size_t)needed + 1;
+        char* grown = realloc(out_buffer, new_capacity);
+        if (!grown) return; // Drop the fragment; the next full redraw repairs the screen
+        out_buffer = grown;
+        out_capacity = new_capacity;
+    }
+}
+
+static void out_flush(void) {
+    if (out_length == 0) return;
+    fwrite(out_buffer, 1, out_length, stdout);
+    fflush(stdout);
+    out_length = 0;
+}
+
+static int frame_bottom_row(void) {
+    return FRAME_GRID_TOP_ROW + frame_height; // Bottom border
+}
+
+static int altitude_colour(int z) {
+    if (z < 0) return 1;
+    int band = z / ALTITUDE_BAND_HEIGHT;
+    return 1 + (band < ALTITUDE_BAND_COUNT ? band : ALTITUDE_BAND_COUNT - 1);
+}
+
+// Fills frame_current from the captured positions. Returns the number of drones drawn.
+static int compose_frame(void) {
+    for (int i = 0; i < frame_width * frame_height; ++i) frame_current[i] = '.';
+
+    int drawn = 0;
+    for (int i = 0; i < captured_count; ++i) {
+        const CapturedDrone* d = &captured_drones[i];
+        if (view.z_slice && (d->z < view.z_min || d->z > view.z_max)) continue;
+        int col = floor_div(d->x - view.view_x, view.zoom);
+        int row_from_bottom = floor_div(d->y - view.view_y, view.zoom);
+        if (col < 0 || col >= frame_width || row_from_bottom < 0 || row_from_bottom >= frame_height) continue;
+
+        FrameCell* cell = &frame_current[(frame_height - 1 - row_from_bottom) * frame_width + col];
+        if ((*cell & 0xFF) == '.') {
+            *cell = (FrameCell)(((d->id % 10) + '0') | (altitude_colour(d->z) << 8));
+        } else {
+            *cell = (FrameCell)('*' | (COLOUR_MULTIPLE << 8));
+        }
+        drawn++;
+    }
+    return drawn;
+}
+
+// Clears the screen, draws borders, labels and legend, and confines other console
+// output to the rows below the frame.
+static void emit_static_layout(void) {
+    out_append("\x1b[0m\x1b[2J");
+
+    struct winsize ws;
+    int bottom = frame_bottom_row() + 2; // Legend rows
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > bottom + 2) {
+        out_append("\x1b[%d;%dr", bottom + 1, ws.ws_row);
+    }
+
+    out_append("\x1b[%d;1H%*s+", FRAME_GRID_TOP_ROW - 1, FRAME_LABEL_WIDTH - 1, "");
+    for (int c = 0; c < frame_width; ++c) out_append("-");
+    out_append("+");
+    for (int r = 0; r < frame_height; ++r) {
+        int world_y = view.view_y + (frame_height - 1 - r) * view.zoom;
+        out_append("\x1b[%d;1H%5d|\x1b[%d;%dH|", FRAME_GRID_TOP_ROW + r, world_y,
+                   FRAME_GRID_TOP_ROW + r, FRAME_LABEL_WIDTH + frame_width + 1);
+    }
+    out_append("\x1b[%d;1H%*s+", frame_bottom_row(), FRAME_LABEL_WIDTH - 1, "");
+    for (int c = 0; c < frame_width; ++c) out_append("-");
+    out_append("+");
+    out_append("\x1b[%d;1H  Legend: '.' empty, digit = drone ID coloured by altitude band "
+               "(\x1b[32mz<%d\x1b[0m \x1b[36m<%d\x1b[0m \x1b[33m<%d\x1b[0m \x1b[35mhigher\x1b[0m), "
+               "'\x1b[1;31m*\x1b[0m' several drones",
+               frame_bottom_row() + 1, ALTITUDE_BAND_HEIGHT, 2 * ALTITUDE_BAND_HEIGHT, 3 * ALTITUDE_BAND_HEIGHT);
+    if (keyboard_enabled) {
+        out_append("\x1b[%d;1H  Keys: h/l/j/k pan, +/- zoom, [/] move z-slice, a all altitudes",
+                   frame_bottom_row() + 2);
+    }
+    out_append("\x1b[%d;1H", bottom + 1);
+
+    for (int i = 0; i < frame_width * frame_height; ++i) frame_previous[i] = CELL_UNDRAWN;
+    last_status_line[0] = '\0';
+}
+
+// Applies any pending single-key viewport commands.
+static void handle_renderer_input(void) {
+    if (!keyboard_enabled) return;
+    char keys[32];
+    ssize_t n = read(STDIN_FILENO, keys, sizeof(keys));
+    int slice_height = view.z_max - view.z_min + 1; // init_diff_renderer guarantees z_max >= z_min
+    for (ssize_t i = 0; i < n; ++i) {
+        switch (keys[i]) {
+            case 'h': pan_viewport(-(frame_width / 4 > 0 ? frame_width / 4 : 1), 0); break;
+            case 'l': pan_viewport(frame_width / 4 > 0 ? frame_width / 4 : 1, 0); break;
+            case 'j': pan_viewport(0, -(frame_height / 4 > 0 ? frame_height / 4 : 1)); break;
+            case 'k': pan_viewport(0, frame_height / 4 > 0 ? frame_height / 4 : 1); break;
+            case '+': case '=': zoom_viewport(view.zoom - 1); break;
+            case '-': zoom_viewport(view.zoom + 1); break;
+            case '[': set_z_slice(1, view.z_min - slice_height, view.z_max - slice_height); break;
+            case ']': set_z_slice(1, view.z_min + slice_height, view.z_max + slice_height); break;
+            case 'a': set_z_slice(!view.z_slice, view.z_min, view.z_max); break;
+            default: break;
+        }
+    }
+}
+
+// SIGINT/SIGTERM: atexit handlers do not run, so undo the terminal changes here
+// (async-signal-safe calls only) and terminate with the default action.
+static void restore_terminal_on_signal(int signum) {
+    static const char reset[] = "\x1b[0m\x1b[r\r\n";
+    ssize_t written = write(STDOUT_FILENO, reset, sizeof(reset) - 1);
+    (void)written;
+    if (keyboard_enabled) tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+    signal(signum, SIG_DFL);
+    raise(signum);
+}
+
+int init_diff_renderer(const DisplayOptions* opts) {
+    view = *opts;
+    if (view.zoom < 1) view.zoom = 1;
+    if (view.view_width <= 0) view.view_width = GRID_WIDTH;
+    if (view.view_height <= 0) view.view_height = GRID_HEIGHT;
+    if (!view.z_slice || view.z_max < view.z_min) {
+        // No --z-slice: the keys start from the lowest altitude band.
+        view.z_min = 0;
+        view.z_max = ALTITUDE_BAND_HEIGHT - 1;
+    }
+    frame_width = view.view_width;
+    frame_height = view.view_height;
+
+    frame_current = malloc((size_t)frame_width * frame_height * sizeof(FrameCell));
+    frame_previous = malloc((size_t)frame_width * frame_height * sizeof(FrameCell));
+    out_capacity = (size_t)frame_width * frame_height * 16 + 4096;
+    out_buffer = malloc(out_capacity);
+    if (!frame_current || !frame_previous || !out_buffer) {
+        perror("UI_DISPLAY: Error allocating renderer buffers");
+        close_diff_renderer();
+        return 0;
+    }
+
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved_termios) == 0) {
+        struct termios raw = saved_termios;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 0;  // read() returns immediately when no key is pending
+        raw.c_cc[VTIME] = 0;
+        keyboard_enabled = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+
+    renderer_active = 1;
+    full_redraw_needed = 1;
+    last_frame_ns = 0;
+    atexit(close_diff_renderer);
+    signal(SIGINT, restore_terminal_on_signal);
+    signal(SIGTERM, restore_terminal_on_signal);
+    return 1;
+}
+
+int capture_drone_frame(int current_time_step, int force) {
+    if (!renderer_active || !shared_mem) return 0;
+
+    long long now = monotonic_ns();
+    if (!force && !full_redraw_needed && view.max_fps > 0 &&
+        now - last_frame_ns < 1000000000LL / view.max_fps) {
+        return 0; // Over the frame-rate cap: the simulation keeps running, this frame is dropped
+    }
+    last_frame_ns = now;
+
+    for (int i = 0; i < num_sim_drones; ++i) {
+        const DroneSharedState* d = &shared_mem->drones[i];
+        captured_drones[i] = (CapturedDrone){ d->id, d->x, d->y, d->z };
+    }
+    captured_count = num_sim_drones;
+    captured_step = current_time_step;
+    frame_pending = 1;
+    return 1;
+}
+
+void draw_captured_frame(void) {
+    if (!renderer_active) return;
+
+    handle_renderer_input();
+    if (!frame_pending) return;
+    frame_pending = 0;
+
+    if (full_redraw_needed) {
+        emit_static_layout();
+        full_redraw_needed = 0;
+    }
+
+    int drawn = compose_frame();
+    out_append("\x1b" "7"); // Save the console cursor, which lives below the frame
+
+    char status[BUFFER_SIZE];
+    char slice[48] = "all";
+    if (view.z_slice) snprintf(slice, sizeof(slice), "%d..%d", view.z_min, view.z_max);
+    snprintf(status, sizeof(status), "Time Step %d | X %d..%d  Y %d..%d | zoom %d | Z %s | drones shown %d/%d",
+             captured_step, view.view_x, view.view_x + frame_width * view.zoom - 1,
+             view.view_y, view.view_y + frame_height * view.zoom - 1, view.zoom, slice, drawn, captured_count);
+    if (strcmp(status, last_status_line) != 0) {
+        out_append("\x1b[1;1H\x1b[0m%s\x1b[K", status);
+        snprintf(last_status_line, sizeof(last_status_line), "%s", status);
+    }
+
+    int cursor_row = -1, cursor_col = -1, colour = -1;
+    for (int r = 0; r < frame_height; ++r) {
+        for (int c = 0; c < frame_width; ++c) {
+            int idx = r * frame_width + c;
+            FrameCell cell = frame_current[idx];
+            if (cell == frame_previous[idx]) continue;
+            int row = FRAME_GRID_TOP_ROW + r;
+            int col = FRAME_LABEL_WIDTH + 1 + c;
+            if (row != cursor_row || col != cursor_col) out_append("\x1b[%d;%dH", row, col);
+            if ((cell >> 8) != colour) {
+                colour = cell >> 8;
+                out_append("\x1b[%sm", cell_colours[colour]);
+            }
+            out_append("%c", (char)(cell & 0xFF));
+            cursor_row = row;
+            cursor_col = col + 1;
+            frame_previous[idx] = cell;
+        }
+    }
+    if (colour > 0) out_append("\x1b[0m");
+    out_append("\x1b" "8");
+    out_flush();
+}
+
+void pan_viewport(int dx_cells, int dy_cells) {
+    view.view_x += dx_cells * view.zoom;
+    view.view_y += dy_cells * view.zoom;
+    full_redraw_needed = 1;
+}
+
+void zoom_viewport(int zoom) {
+    if (zoom < 1) zoom = 1;
+    if (zoom == view.zoom) return;
+    // Keep the viewport centre fixed while zooming.
+    int centre_x = view.view_x + frame_width * view.zoom / 2;
+    int centre_y = view.view_y + frame_height * view.zoom / 2;
+    view.zoom = zoom;
+    view.view_x = centre_x - frame_width * zoom / 2;
+    view.view_y = centre_y - frame_height * zoom / 2;
+    full_redraw_needed = 1;
+}
+
+void set_z_slice(int enabled, int z_min, int z_max) {
+    view.z_slice = enabled;
+    if (z_max >= z_min) {
+        view.z_min = z_min;
+        view.z_max = z_max;
+    }
+    full_redraw_needed = 1;
+}
+
+void close_diff_renderer(void) {
+    if (renderer_active) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        // Reset the scroll region and leave the cursor under the frame.
+        printf("\x1b[0m\x1b[r\x1b[%d;1H\n", frame_bottom_row() + 3);
+        fflush(stdout);
+        renderer_active = 0;
+    }
+    if (keyboard_enabled) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+        keyboard_enabled = 0;
+    }
+    free(frame_current);
+    free(frame_previous);
+    free(out_buffer);
+    frame_current = frame_previous = NULL;
+    out_buffer = NULL;
+    out_length = out_capacity = 0;
+}
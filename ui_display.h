@@ -17,4 +17,34 @@ void display_drone_grid(int current_time_step);
 // Function to print a summary of drone states (already somewhat in main_controller)
 void display_drone_summary_list(int current_time_step);
 
+// --- Incremental (diff-based) renderer ---
+// Each frame is composed into a cell buffer and compared with the previous one; only the
+// ANSI cursor moves and characters for changed cells are written, in a single write.
+// Drone digits are coloured by altitude band so overlapping altitudes can be told apart.
+
+// Default frame-rate cap when none is given on the command line.
+#define DIFF_RENDERER_DEFAULT_FPS 30
+
+// Sets up the renderer (and, if stdin is a terminal, single-key viewport controls:
+// h/l/j/k pan, +/- zoom, [/] move the z-slice, a toggles all altitudes).
+// Returns 1 on success, 0 on failure.
+int init_diff_renderer(const DisplayOptions* opts);
+
+// Copies the current drone positions for the next frame; call with data_mutex held.
+// Frames arriving faster than the frame-rate cap are dropped unless `force` is set
+// (e.g. for the final state). Returns 1 if a frame was captured.
+int capture_drone_frame(int current_time_step, int force);
+
+// Handles pending keys and draws the last captured frame, if any. Does terminal I/O,
+// so call it after releasing data_mutex.
+void draw_captured_frame(void);
+
+// Viewport controls (also bound to keys). Any change triggers a full redraw.
+void pan_viewport(int dx_cells, int dy_cells);
+void zoom_viewport(int zoom);
+void set_z_slice(int enabled, int z_min, int z_max);
+
+// Restores the terminal and moves the cursor below the frame. Safe to call twice.
+void close_diff_renderer(void);
+
 #endif // UI_DISPLAY_H
\ No newline at end of file